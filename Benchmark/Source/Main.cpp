@@ -0,0 +1,261 @@
+/*
+  ==============================================================================
+
+    This file contains the basic startup code for a JUCE application.
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "../../Source/NoiseGenerator.h"
+#include "../../Source/NoiseAnalysis.h"
+#include "../../Source/ColouredNoise.h"
+#include <complex>
+#include <iomanip>
+
+//==============================================================================
+static const int BLOCK_SIZES[] = { 1, 16, 64, 256, 1024, 4096 };
+static const int NUM_BLOCK_SIZES = (int)(sizeof(BLOCK_SIZES) / sizeof(BLOCK_SIZES[0]));
+
+static const int HISTOGRAM_BINS = 64;
+static const int FFT_ORDER = 10;
+static const int PERIOD_WINDOW = 64;
+
+static const double SLOPE_SAMPLE_RATES[] = { 44100.0, 48000.0, 88200.0, 96000.0, 192000.0 };
+static const float SLOPES[] = { -12.0f, -9.0f, -7.5f, -6.0f, -4.5f, -3.0f, -1.0f, 1.0f, 3.0f, 6.0f, 9.0f, 12.0f };
+
+// dB per octave any octave from 20 Hz to 20 kHz may be off, slopes steeper than
+// 6 dB per octave run through one more section
+static const double SLOPE_TOLERANCE = 0.3;
+static const double STEEP_SLOPE_TOLERANCE = 0.7;
+
+// Counter mode velvet noise has one impulse per cell wherever it starts, up to
+// the free running position synced noise uses with the transport stopped
+static const uint64_t VELVET_POSITIONS[] = { 0, 1ull << 40, 1ull << 62 };
+static const float VELVET_SPACING = 24.0f;
+static const int VELVET_SAMPLES = 102400;
+
+struct Settings
+{
+	int timedSamples = 1 << 22;
+	int analysedSamples = 1 << 20;
+};
+
+static void printUsage()
+{
+	std::cout << "Usage: NoiseBenchmark [options]" << std::endl
+		<< "  --timed samples       default 4194304, per generator and block size" << std::endl
+		<< "  --analysed samples    default 1048576, per generator" << std::endl;
+}
+
+static void printHeader()
+{
+	std::cout << std::left << std::setw(26) << "generator";
+	for (int i = 0; i < NUM_BLOCK_SIZES; i++)
+	{
+		std::cout << std::right << std::setw(10) << ("ns@" + std::to_string(BLOCK_SIZES[i]));
+	}
+	std::cout << std::setw(10) << "Msmp/s" << std::setw(12) << "chi2/dof" << std::setw(10) << "lag1" << std::setw(10) << "flatness" << std::setw(10) << "period" << std::endl;
+}
+
+//==============================================================================
+// Cost at every block size, then quality of one long block against the CDF
+template <typename Generator, typename Cdf>
+static void measure(const char* name, Generator& generator, Cdf cdf, const Settings& settings)
+{
+	std::cout << std::left << std::setw(26) << name << std::right << std::fixed;
+
+	double best = 0.0;
+	for (int i = 0; i < NUM_BLOCK_SIZES; i++)
+	{
+		const double nanoseconds = NoiseAnalysis::nanosecondsPerSample(generator, BLOCK_SIZES[i], settings.timedSamples);
+		best = i == 0 || nanoseconds < best ? nanoseconds : best;
+		std::cout << std::setw(10) << std::setprecision(2) << nanoseconds;
+	}
+
+	std::vector<float> data((size_t)settings.analysedSamples);
+	generator.processBlock(data.data(), settings.analysedSamples, 1.0f);
+
+	double observed[HISTOGRAM_BINS] = {};
+	double expected[HISTOGRAM_BINS] = {};
+	NoiseAnalysis::histogram(data.data(), settings.analysedSamples, -1.0f, 1.0f, observed, HISTOGRAM_BINS);
+	NoiseAnalysis::expectedCounts(cdf, settings.analysedSamples, -1.0f, 1.0f, expected, HISTOGRAM_BINS);
+
+	int degreesOfFreedom = 0;
+	const double chiSquare = NoiseAnalysis::chiSquare(observed, expected, HISTOGRAM_BINS, &degreesOfFreedom);
+
+	std::cout << std::setw(10) << std::setprecision(1) << (best > 0.0 ? 1000.0 / best : 0.0)
+		<< std::setw(12) << std::setprecision(2) << (degreesOfFreedom > 0 ? chiSquare / degreesOfFreedom : 0.0)
+		<< std::setw(10) << std::setprecision(4) << NoiseAnalysis::autocorrelation(data.data(), settings.analysedSamples, 1)
+		<< std::setw(10) << std::setprecision(4) << NoiseAnalysis::spectralFlatness(data.data(), settings.analysedSamples, FFT_ORDER);
+
+	// Searched in the second half, so a start-up transient does not hide a cycle.
+	// 0 means no repeat within it.
+	const int half = settings.analysedSamples / 2;
+	const int period = NoiseAnalysis::findPeriod(data.data() + half, settings.analysedSamples - half, PERIOD_WINDOW);
+	std::cout << std::setw(10) << (period > 0 ? std::to_string(period) : std::string("-")) << std::endl;
+}
+
+//==============================================================================
+// Level of the custom slope cascade, from its coefficients in double
+static double slopeLevel(const ColouredNoise::Slope& slope, double frequency)
+{
+	const std::complex<double> zInverse = std::polar(1.0, -2.0 * juce::MathConstants<double>::pi * frequency / slope.sampleRate);
+
+	std::complex<double> response = ((double)slope.extraB0 + (double)slope.extraB1 * zInverse) / (1.0 + (double)slope.extraA1 * zInverse);
+	for (int k = 0; k < ColouredNoise::SLOPE_STAGES; k++)
+	{
+		response *= ((double)slope.b0[k] + (double)slope.b1[k] * zInverse) / (1.0 + (double)slope.a1[k] * zInverse);
+	}
+
+	return 10.0 * std::log10(std::norm(response));
+}
+
+// Worst dB per octave error of every octave below 20 kHz, false if any is out of tolerance
+static bool checkSlopes()
+{
+	std::cout << std::left << std::setw(26) << "slope dB/oct";
+	for (double sampleRate : SLOPE_SAMPLE_RATES)
+	{
+		std::cout << std::right << std::setw(10) << (std::to_string((int)sampleRate) + "Hz");
+	}
+	std::cout << std::endl;
+
+	bool passed = true;
+	for (float target : SLOPES)
+	{
+		std::cout << std::left << std::fixed << std::setprecision(1) << std::setw(26) << target << std::right;
+
+		const double tolerance = std::abs(target) > 6.0f ? STEEP_SLOPE_TOLERANCE : SLOPE_TOLERANCE;
+		for (double sampleRate : SLOPE_SAMPLE_RATES)
+		{
+			ColouredNoise::Slope slope;
+			slope.design(sampleRate, target);
+
+			double worst = 0.0;
+			for (double frequency = 20000.0; frequency > 30.0; frequency *= 0.5)
+			{
+				const double error = std::abs(slopeLevel(slope, frequency) - slopeLevel(slope, 0.5 * frequency) - target);
+				worst = error > worst ? error : worst;
+			}
+
+			passed = passed && worst <= tolerance;
+			std::cout << std::setw(9) << std::setprecision(2) << worst << (worst <= tolerance ? " " : "!");
+		}
+		std::cout << std::endl;
+	}
+
+	return passed;
+}
+
+// Impulses counted in blocks from each base position, false if any count is
+// off by more than the two cells cut at the ends
+static bool checkVelvet()
+{
+	const int blockSize = 512;
+	const int expected = (int)((float)VELVET_SAMPLES / VELVET_SPACING);
+
+	std::cout << std::left << std::setw(26) << "velvet impulses" << std::right << std::setw(10) << expected << " expected" << std::endl;
+
+	bool passed = true;
+	std::vector<float> block((size_t)blockSize);
+	for (uint64_t base : VELVET_POSITIONS)
+	{
+		WhiteNoiseGenerator generator;
+		generator.setCounterKey(123, 0);
+		generator.setDistributionType(WhiteNoiseGenerator::DistributionType::Velvet);
+		generator.setVelvetDensity(1.0f / VELVET_SPACING);
+
+		int count = 0;
+		for (int start = 0; start < VELVET_SAMPLES; start += blockSize)
+		{
+			generator.processBlockAt(base + (uint64_t)start, block.data(), blockSize, 1.0f);
+			count += (int)std::count_if(block.begin(), block.end(), [](float x) { return x != 0.0f; });
+		}
+
+		const bool ok = std::abs(count - expected) <= 2;
+		passed = passed && ok;
+		std::cout << std::left << std::setw(26) << ("at " + std::to_string(base)) << std::right << std::setw(10) << count << (ok ? "" : " !") << std::endl;
+	}
+
+	return passed;
+}
+
+//==============================================================================
+int main (int argc, char* argv[])
+{
+	juce::ArgumentList arguments(argc, argv);
+
+	if (arguments.containsOption("--help|-h"))
+	{
+		printUsage();
+		return 0;
+	}
+
+	Settings settings;
+	if (arguments.containsOption("--timed"))
+		settings.timedSamples = juce::jmax(1, arguments.getValueForOption("--timed").getIntValue());
+	if (arguments.containsOption("--analysed"))
+		settings.analysedSamples = juce::jmax(1 << FFT_ORDER, arguments.getValueForOption("--analysed").getIntValue());
+
+	const auto uniform = [](double x) { return NoiseAnalysis::uniformCdf(x); };
+
+	const bool slopesPassed = checkSlopes();
+	const bool velvetPassed = checkVelvet();
+
+	std::cout << "Kernels " << NoiseKernels::getInstructionSet() << " (0 scalar, 1 SSE2, 2 AVX2)" << std::endl;
+	printHeader();
+
+	// Generators the plugin started out with
+	{
+		RandomNoiseGenerator generator;
+		measure("Random", generator, uniform, settings);
+	}
+	{
+		FastNoiseGenerator generator;
+		measure("Fast", generator, uniform, settings);
+	}
+	{
+		MiddleSquareNoiseGenerator generator;
+		measure("MiddleSquare", generator, uniform, settings);
+	}
+	{
+		LehmerNoiseGenerator generator;
+		measure("Lehmer", generator, uniform, settings);
+	}
+	{
+		LinearCongruentialNoiseGenerator generator;
+		measure("LinearCongruential", generator, uniform, settings);
+	}
+	{
+		LaggedFibonacciNoiseGenerator generator;
+		measure("LaggedFibonacci", generator, uniform, settings);
+	}
+	{
+		MersenneTwisterNoiseGenerator generator;
+		measure("MersenneTwister", generator, uniform, settings);
+	}
+
+	// The plugin's generator on every engine
+	const char* engineNames[] = { "MersenneTwister", "Pcg32", "Xoshiro256Plus", "Xoshiro128Plus", "Sfc32", "SplitMix64", "FastNoise", "LinearCongruential", "Lehmer", "LaggedFibonacci" };
+	for (int engine = 0; engine < (int)(sizeof(engineNames) / sizeof(engineNames[0])); engine++)
+	{
+		WhiteNoiseGenerator generator;
+		generator.setStream(123, 0);
+		generator.setEngine((NoiseEngine::Type)engine);
+		generator.setDistributionType(WhiteNoiseGenerator::DistributionType::Uniform);
+
+		measure((std::string("Uniform ") + engineNames[engine]).c_str(), generator, uniform, settings);
+	}
+
+	// Ziggurat, the same standard deviation as the plugin's Normal mode
+	{
+		WhiteNoiseGenerator generator;
+		generator.setStream(123, 0);
+		generator.setDistributionType(WhiteNoiseGenerator::DistributionType::Normal);
+
+		measure("Normal MersenneTwister", generator, [](double x) { return NoiseAnalysis::normalCdf(x, 0.65); }, settings);
+	}
+
+	return slopesPassed && velvetPassed ? 0 : 1;
+}
@@ -0,0 +1,270 @@
+/*
+  ==============================================================================
+
+    This file contains the basic startup code for a JUCE application.
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "../../Source/PluginProcessor.h"
+#include "../../Source/RealtimeGuard.h"
+
+#if ! NOISE_GENERATOR_REALTIME_CHECKS
+	#error NoiseRealtimeTest needs NOISE_GENERATOR_REALTIME_CHECKS
+#endif
+
+//==============================================================================
+static const double SAMPLE_RATES[] = { 44100.0, 48000.0, 96000.0, 192000.0 };
+static const int BLOCK_SIZES[] = { 1, 7, 64, 127, 512, 1000, 4096 };
+
+// Long enough for the processor's timer to fire at least once
+static const int MESSAGE_PUMP_MS = NoiseGeneratorAudioProcessor::MESSAGE_POLL_MS + 20;
+
+// A parameter automated from one plain value to the other and back over a run
+struct Sweep
+{
+	const char* id;
+	float from;
+	float to;
+};
+
+// Parameter values on top of the defaults, plain values, choices by index
+struct Preset
+{
+	const char* name;
+	std::vector<std::pair<const char*, float>> values;
+	bool notes = false;
+	std::vector<Sweep> sweeps = {};
+};
+
+static std::vector<Preset> getPresets()
+{
+	return {
+		{ "Uniform", {}, false, { { "Volume", -24.0f, 12.0f } } },
+		{ "Normal", { { "ButtonB", 1.0f } } },
+		{ "Velvet", { { "ButtonE", 1.0f } }, false, { { "Density", 100.0f, 10000.0f } } },
+		{ "Pink", { { "Colour", 1.0f } } },
+		{ "Slope", { { "Colour", 5.0f }, { "Slope", -4.5f } }, false, { { "Slope", -12.0f, 12.0f } } },
+		{ "Sync", { { "Sync", 1.0f } } },
+		{ "Spectral", { { "Shape", 1.0f } }, false, { { "Shape", 1.0f, 3.0f }, { "Band", 100.0f, 8000.0f }, { "Frame", 0.0f, 4.0f } } },
+		{ "BandLimit", { { "BandLimit", 1.0f } }, false, { { "Bandwidth", 50.0f, 15000.0f } } },
+		{ "Shared", { { "Shared", 1.0f } }, false, { { "Colour", 0.0f, 4.0f } } },
+		{ "Prefill", { { "Prefill", 1.0f } } },
+		{ "Parallel", { { "Parallel", 1.0f } }, false, { { "Colour", 0.0f, 5.0f } } },
+		{ "PCG32", { { "Engine", 1.0f } } },
+		{ "Voices", { { "Voices", 1.0f }, { "Filter", 1.0f } }, true,
+			{ { "Attack", 0.001f, 0.05f }, { "Release", 0.01f, 0.5f }, { "Filter", 1.0f, 3.0f }, { "Resonance", 0.5f, 12.0f } } },
+		{ "Dither", { { "Dither", 4.0f } }, false, { { "Dither", 1.0f, 4.0f }, { "DitherDepth", 0.0f, 2.0f } } }
+	};
+}
+
+struct Layout
+{
+	const char* name;
+	juce::AudioChannelSet channels;
+};
+
+static std::vector<Layout> getLayouts()
+{
+	return {
+		{ "mono", juce::AudioChannelSet::mono() },
+		{ "stereo", juce::AudioChannelSet::stereo() },
+		{ "7.1.4", juce::AudioChannelSet::create7point1point4() },
+		{ "64", juce::AudioChannelSet::discreteChannels(64) }
+	};
+}
+
+struct Result
+{
+	double realtimeFactor = 0.0;
+	uint64_t allocations = 0;
+	uint64_t blockingCalls = 0;
+};
+
+//==============================================================================
+static void applyPreset(NoiseGeneratorAudioProcessor& processor, const Preset& preset)
+{
+	for (auto* parameter : processor.getParameters())
+	{
+		parameter->setValueNotifyingHost(parameter->getDefaultValue());
+	}
+
+	for (const auto& value : preset.values)
+	{
+		if (auto* parameter = processor.apvts.getParameter(value.first))
+			parameter->setValueNotifyingHost(parameter->convertTo0to1(value.second));
+	}
+}
+
+// Sets every sweep to where it is at this point of the run, 0 to 1
+static void automate(NoiseGeneratorAudioProcessor& processor, const Preset& preset, double progress)
+{
+	const float position = (float)(1.0 - std::abs(2.0 * progress - 1.0));
+
+	for (const auto& sweep : preset.sweeps)
+	{
+		if (auto* parameter = processor.apvts.getParameter(sweep.id))
+		{
+			const float value = parameter->convertTo0to1(sweep.from + position * (sweep.to - sweep.from));
+			if (value != parameter->getValue())
+				parameter->setValueNotifyingHost(value);
+		}
+	}
+}
+
+// Lets the processor's timer run, so shared tables, Prefill, voice seeding,
+// spectral magnitudes and latency catch up like they would in a host
+static void pumpMessages()
+{
+	juce::MessageManager::getInstance()->runDispatchLoopUntil(MESSAGE_PUMP_MS);
+}
+
+// Blocks of audio, timed and guarded as a whole, in groups with the message
+// thread running in between. Sweeps move before every block like host
+// automation. MIDI is built outside the processor, the host owns that memory.
+template <typename SampleType>
+static Result run(NoiseGeneratorAudioProcessor& processor, const Preset& preset, int channels, double sampleRate, int blockSize, double seconds, int groups)
+{
+	juce::AudioBuffer<SampleType> buffer(channels, blockSize);
+	juce::MidiBuffer midi;
+	midi.ensureSize(256);
+
+	const int64_t totalSamples = (int64_t)(seconds * sampleRate);
+	const int64_t halfNote = (int64_t)(0.025 * sampleRate);
+	const int64_t groupSamples = juce::jmax((int64_t)1, totalSamples / groups);
+
+	const uint64_t allocations = RealtimeGuard::getAllocations();
+	const uint64_t blockingCalls = RealtimeGuard::getBlockingCalls();
+	double busy = 0.0;
+
+	for (int64_t position = 0, nextGroup = groupSamples; position < totalSamples; position += blockSize)
+	{
+		if (position >= nextGroup)
+		{
+			pumpMessages();
+			nextGroup += groupSamples;
+		}
+
+		automate(processor, preset, (double)position / (double)totalSamples);
+
+		midi.clear();
+		if (preset.notes)
+		{
+			// A new note every 50 ms, held for half of that
+			for (int64_t event = (position + halfNote - 1) / halfNote * halfNote; event < position + blockSize; event += halfNote)
+			{
+				const int offset = (int)(event - position);
+				const int number = 36 + (int)((event / (2 * halfNote)) % 48);
+				midi.addEvent((event / halfNote) % 2 == 0 ? juce::MidiMessage::noteOn(1, number, 0.8f) : juce::MidiMessage::noteOff(1, number), offset);
+			}
+		}
+
+		// Dither needs an input
+		for (int channel = 0; channel < channels; channel++)
+		{
+			buffer.getWritePointer(channel)[0] = (SampleType)0.25;
+		}
+
+		const double start = juce::Time::getMillisecondCounterHiRes();
+		processor.processBlock(buffer, midi);
+		busy += juce::Time::getMillisecondCounterHiRes() - start;
+	}
+
+	Result result;
+	result.realtimeFactor = busy > 0.0 ? 1000.0 * seconds / busy : 0.0;
+	result.allocations = RealtimeGuard::getAllocations() - allocations;
+	result.blockingCalls = RealtimeGuard::getBlockingCalls() - blockingCalls;
+	return result;
+}
+
+//==============================================================================
+int main (int argc, char* argv[])
+{
+	juce::ArgumentList arguments(argc, argv);
+
+	if (arguments.containsOption("--help|-h"))
+	{
+		std::cout << "Usage: NoiseRealtimeTest [options]" << std::endl
+			<< "  --seconds value       default 0.25, audio per preset and configuration" << std::endl
+			<< "  --groups value        default 4, message thread runs between groups of blocks" << std::endl
+			<< "  --double              process double buffers" << std::endl;
+		return 0;
+	}
+
+	const double seconds = arguments.containsOption("--seconds") ? arguments.getValueForOption("--seconds").getDoubleValue() : 0.25;
+	const int groups = arguments.containsOption("--groups") ? juce::jmax(1, arguments.getValueForOption("--groups").getIntValue()) : 4;
+	const bool doublePrecision = arguments.containsOption("--double");
+
+	// The processor polls on a timer, which needs a message manager
+	juce::ScopedJuceInitialiser_GUI juceInitialiser;
+
+	const auto presets = getPresets();
+	uint64_t failures = 0;
+	double worstFactor = -1.0;
+
+	std::cout << "layout   rate    block   worst x real time   preset" << std::endl;
+
+	for (const auto& layout : getLayouts())
+	{
+		for (const double sampleRate : SAMPLE_RATES)
+		{
+			for (const int blockSize : BLOCK_SIZES)
+			{
+				double worst = -1.0;
+				const char* worstPreset = "";
+
+				for (const auto& preset : presets)
+				{
+					// A fresh instance per run, like a host inserting the plugin
+					NoiseGeneratorAudioProcessor processor;
+
+					juce::AudioProcessor::BusesLayout buses;
+					buses.inputBuses.add(layout.channels);
+					buses.outputBuses.add(layout.channels);
+					if (!processor.setBusesLayout(buses))
+					{
+						std::cout << layout.name << " layout not supported" << std::endl;
+						return 1;
+					}
+
+					processor.setProcessingPrecision(doublePrecision ? juce::AudioProcessor::doublePrecision : juce::AudioProcessor::singlePrecision);
+					processor.setRateAndBufferSizeDetails(sampleRate, blockSize);
+					applyPreset(processor, preset);
+					processor.prepareToPlay(sampleRate, blockSize);
+					pumpMessages();
+
+					const int channels = layout.channels.size();
+					const auto result = doublePrecision ? run<double>(processor, preset, channels, sampleRate, blockSize, seconds, groups)
+						: run<float>(processor, preset, channels, sampleRate, blockSize, seconds, groups);
+
+					processor.releaseResources();
+
+					if (result.allocations > 0 || result.blockingCalls > 0)
+					{
+						std::cout << "FAIL " << layout.name << " " << sampleRate << " Hz, " << blockSize << " samples, " << preset.name << ": "
+							<< result.allocations << " allocations, " << result.blockingCalls << " blocking calls" << std::endl;
+						failures++;
+					}
+
+					if (worst < 0.0 || result.realtimeFactor < worst)
+					{
+						worst = result.realtimeFactor;
+						worstPreset = preset.name;
+					}
+				}
+
+				std::cout << juce::String(layout.name).paddedRight(' ', 9)
+					<< juce::String((int)sampleRate).paddedRight(' ', 8)
+					<< juce::String(blockSize).paddedRight(' ', 8)
+					<< juce::String(worst, 1).paddedRight(' ', 20)
+					<< worstPreset << std::endl;
+
+				worstFactor = worstFactor < 0.0 || worst < worstFactor ? worst : worstFactor;
+			}
+		}
+	}
+
+	std::cout << "Worst real time factor " << juce::String(worstFactor, 1) << ", " << (int)failures << " failing runs" << std::endl;
+	return failures > 0 ? 1 : 0;
+}
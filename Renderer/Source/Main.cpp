@@ -0,0 +1,96 @@
+/*
+  ==============================================================================
+
+    This file contains the basic startup code for a JUCE application.
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "OfflineRenderer.h"
+
+//==============================================================================
+static void printUsage()
+{
+	std::cout << "Usage: NoiseRenderer --output file.wav|file.flac [options]" << std::endl
+		<< "  --duration seconds    default 10" << std::endl
+		<< "  --channels count      default 2" << std::endl
+		<< "  --rate hz             default 48000" << std::endl
+		<< "  --bits 16|24|32       default 24, 32 is float and WAV only" << std::endl
+		<< "  --type uniform|normal|bernoulli|piecewise|velvet" << std::endl
+		<< "  --density hz          default 2000, velvet impulses per second" << std::endl
+		<< "  --volume db           default 0, same as the plugin Volume" << std::endl
+		<< "  --seed value          default 123" << std::endl
+		<< "  --threads count       default every core" << std::endl;
+}
+
+static bool parseDistributionType(const juce::String& name, WhiteNoiseGenerator::DistributionType& distributionType)
+{
+	const juce::StringArray names{ "uniform", "normal", "bernoulli", "piecewise", "velvet" };
+	const int index = names.indexOf(name, true);
+
+	if (index < 0)
+		return false;
+
+	distributionType = (WhiteNoiseGenerator::DistributionType)index;
+	return true;
+}
+
+//==============================================================================
+int main (int argc, char* argv[])
+{
+	juce::ArgumentList arguments(argc, argv);
+
+	if (arguments.size() == 0 || arguments.containsOption("--help|-h") || !arguments.containsOption("--output"))
+	{
+		printUsage();
+		return arguments.size() == 0 ? 1 : 0;
+	}
+
+	OfflineRenderer::Settings settings;
+	settings.output = juce::File::getCurrentWorkingDirectory().getChildFile(arguments.getValueForOption("--output"));
+
+	if (arguments.containsOption("--duration"))
+		settings.duration = arguments.getValueForOption("--duration").getDoubleValue();
+	if (arguments.containsOption("--channels"))
+		settings.channels = arguments.getValueForOption("--channels").getIntValue();
+	if (arguments.containsOption("--rate"))
+		settings.sampleRate = arguments.getValueForOption("--rate").getDoubleValue();
+	if (arguments.containsOption("--bits"))
+		settings.bitsPerSample = arguments.getValueForOption("--bits").getIntValue();
+	if (arguments.containsOption("--density"))
+		settings.velvetDensity = arguments.getValueForOption("--density").getFloatValue();
+	if (arguments.containsOption("--volume"))
+		settings.volume = arguments.getValueForOption("--volume").getFloatValue();
+	if (arguments.containsOption("--seed"))
+		settings.seed = (uint32_t)arguments.getValueForOption("--seed").getLargeIntValue();
+	if (arguments.containsOption("--threads"))
+		settings.threads = arguments.getValueForOption("--threads").getIntValue();
+
+	if (arguments.containsOption("--type") && !parseDistributionType(arguments.getValueForOption("--type"), settings.distributionType))
+	{
+		std::cerr << "Unknown type " << arguments.getValueForOption("--type") << std::endl;
+		return 1;
+	}
+
+	int lastPercent = -1;
+	const auto result = OfflineRenderer::render(settings, [&lastPercent](double progress)
+	{
+		const int percent = (int)(progress * 100.0);
+		if (percent != lastPercent)
+		{
+			std::cout << "\r" << percent << "%" << std::flush;
+			lastPercent = percent;
+		}
+	});
+	std::cout << std::endl;
+
+	if (result.failed())
+	{
+		std::cerr << result.getErrorMessage() << std::endl;
+		return 1;
+	}
+
+	std::cout << "Written " << settings.output.getFullPathName() << std::endl;
+	return 0;
+}
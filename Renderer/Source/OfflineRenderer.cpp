@@ -0,0 +1,154 @@
+/*
+  ==============================================================================
+
+    OfflineRenderer.cpp
+    Created: 18 Oct 2026 1:04:51pm
+    Author:  zazz
+
+  ==============================================================================
+*/
+
+#include "OfflineRenderer.h"
+
+//==============================================================================
+namespace
+{
+	struct Slot
+	{
+		juce::AudioBuffer<float> buffer;
+		int frames = 0;
+		juce::WaitableEvent done;
+	};
+}
+
+//==============================================================================
+juce::Result OfflineRenderer::render(const Settings& settings, std::function<void(double)> progress)
+{
+	if (settings.channels < 1 || settings.sampleRate <= 0.0 || settings.duration <= 0.0)
+		return juce::Result::fail("Channels, sample rate and duration have to be positive");
+
+	const juce::int64 totalFrames = (juce::int64)std::llround(settings.duration * settings.sampleRate);
+	const int chunkFrames = getChunkFrames(settings.channels);
+	const juce::int64 numChunks = (totalFrames + chunkFrames - 1) / chunkFrames;
+
+	juce::String error;
+	auto writer = createWriter(settings, error);
+	if (writer == nullptr)
+		return juce::Result::fail(error);
+
+	const int threads = settings.threads > 0 ? settings.threads : juce::SystemStats::getNumCpus();
+	const int numSlots = (int)juce::jmin((juce::int64)threads * CHUNKS_PER_THREAD, numChunks);
+
+	juce::OwnedArray<Slot> slots;
+	for (int i = 0; i < numSlots; i++)
+	{
+		slots.add(new Slot())->buffer.setSize(settings.channels, chunkFrames);
+	}
+
+	// Declared after the slots, so it is destroyed first and no job outlives them
+	juce::ThreadPool pool(threads);
+
+	juce::int64 nextChunk = 0;
+	auto startChunk = [&]()
+	{
+		Slot* slot = slots[(int)(nextChunk % numSlots)];
+		const juce::int64 chunk = nextChunk++;
+		slot->frames = (int)juce::jmin((juce::int64)chunkFrames, totalFrames - chunk * chunkFrames);
+
+		pool.addJob([&settings, chunk, slot]()
+		{
+			renderChunk(settings, chunk, slot->frames, slot->buffer);
+			slot->done.signal();
+		});
+	};
+
+	while (nextChunk < numSlots)
+	{
+		startChunk();
+	}
+
+	// Chunks are written in order, a slot is reused as soon as its chunk is on disk
+	bool written = true;
+	for (juce::int64 chunk = 0; chunk < nextChunk; chunk++)
+	{
+		Slot* slot = slots[(int)(chunk % numSlots)];
+		slot->done.wait();
+
+		if (written)
+			written = writer->writeFromAudioSampleBuffer(slot->buffer, 0, slot->frames);
+
+		if (written && nextChunk < numChunks)
+			startChunk();
+
+		if (written && progress != nullptr)
+			progress((double)(chunk + 1) / (double)numChunks);
+	}
+
+	// Finishes the header
+	writer.reset();
+
+	if (!written)
+		return juce::Result::fail("Could not write to " + settings.output.getFullPathName());
+
+	return juce::Result::ok();
+}
+
+std::unique_ptr<juce::AudioFormatWriter> OfflineRenderer::createWriter(const Settings& settings, juce::String& error)
+{
+	std::unique_ptr<juce::AudioFormat> format;
+	if (settings.output.hasFileExtension("wav"))
+		format = std::make_unique<juce::WavAudioFormat>();
+	else if (settings.output.hasFileExtension("flac"))
+		format = std::make_unique<juce::FlacAudioFormat>();
+
+	if (format == nullptr)
+	{
+		error = "Output has to be a .wav or .flac file";
+		return nullptr;
+	}
+
+	if (!format->getPossibleBitDepths().contains(settings.bitsPerSample))
+	{
+		error = format->getFormatName() + " does not support " + juce::String(settings.bitsPerSample) + " bits";
+		return nullptr;
+	}
+
+	settings.output.deleteFile();
+	std::unique_ptr<juce::FileOutputStream> stream = settings.output.createOutputStream();
+
+	if (stream == nullptr || stream->failedToOpen())
+	{
+		error = "Could not open " + settings.output.getFullPathName();
+		return nullptr;
+	}
+
+	// The writer owns the stream once it exists
+	std::unique_ptr<juce::AudioFormatWriter> writer(format->createWriterFor(stream.get(), settings.sampleRate, (unsigned int)settings.channels, settings.bitsPerSample, {}, 0));
+
+	if (writer == nullptr)
+	{
+		error = format->getFormatName() + " does not support this sample rate or channel count";
+		return nullptr;
+	}
+
+	stream.release();
+	return writer;
+}
+
+void OfflineRenderer::renderChunk(const Settings& settings, juce::int64 chunk, int frames, juce::AudioBuffer<float>& buffer)
+{
+	// Counter mode, a chunk starts at its position without seeding anything. Channel
+	// n is stream n of the seed, the same as synced noise in the plugin.
+	WhiteNoiseGenerator generator;
+	generator.setDistributionType(settings.distributionType);
+	generator.setVelvetDensity((float)(settings.velvetDensity / settings.sampleRate));
+
+	const float gain = juce::Decibels::decibelsToGain(settings.volume) * juce::Decibels::decibelsToGain(WhiteNoiseGenerator::getLevelTrim(settings.distributionType));
+	const uint64_t position = (uint64_t)chunk * (uint64_t)getChunkFrames(settings.channels);
+
+	for (int channel = 0; channel < settings.channels; channel++)
+	{
+		generator.setCounterKey(settings.seed, (uint32_t)channel);
+		generator.processBlockAt(position, buffer.getWritePointer(channel), frames, gain);
+	}
+}
@@ -0,0 +1,62 @@
+/*
+  ==============================================================================
+
+    OfflineRenderer.h
+    Created: 18 Oct 2026 1:04:51pm
+    Author:  zazz
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "../../Source/NoiseGenerator.h"
+
+//==============================================================================
+// Renders noise straight to a WAV or FLAC file. The timeline is split into
+// chunks rendered on a thread pool. Every channel is a counter stream that any
+// chunk can start in, so the file only depends on the settings and never on the
+// thread count or the chunk size.
+class OfflineRenderer
+{
+public:
+	struct Settings
+	{
+		juce::File output;
+		double duration = 10.0;
+		int channels = 2;
+		double sampleRate = 48000.0;
+		int bitsPerSample = 24;
+		WhiteNoiseGenerator::DistributionType distributionType = WhiteNoiseGenerator::DistributionType::Uniform;
+
+		// Velvet impulses per second
+		float velvetDensity = 2000.0f;
+
+		// Same gain staging as the plugin, volume in dB plus the distribution trim
+		float volume = 0.0f;
+		uint32_t seed = 123;
+
+		// 0 uses every core
+		int threads = 0;
+	};
+
+	// Each chunk holds about this many samples over all channels
+	static const int CHUNK_SAMPLES = 1 << 19;
+	static const int MIN_CHUNK_FRAMES = 1 << 12;
+
+	// Chunks rendered or waiting to be written per thread, bounds the memory
+	static const int CHUNKS_PER_THREAD = 2;
+
+	static int getChunkFrames(int channels)
+	{
+		return juce::jmax(MIN_CHUNK_FRAMES, CHUNK_SAMPLES / juce::jmax(1, channels));
+	}
+
+	// Progress gets the fraction written so far, called from the calling thread
+	static juce::Result render(const Settings& settings, std::function<void(double)> progress = nullptr);
+
+private:
+	static std::unique_ptr<juce::AudioFormatWriter> createWriter(const Settings& settings, juce::String& error);
+	static void renderChunk(const Settings& settings, juce::int64 chunk, int frames, juce::AudioBuffer<float>& buffer);
+};
@@ -0,0 +1,117 @@
+/*
+  ==============================================================================
+
+    AmplitudePdfEditor.cpp
+    Created: 18 Oct 2026 4:12:36pm
+    Author:  zazz
+
+  ==============================================================================
+*/
+
+#include "AmplitudePdfEditor.h"
+
+//==============================================================================
+void AmplitudePdfEditor::setWeights(const std::vector<float>& weights)
+{
+	m_weights = weights.empty() ? AliasTable::getDefault().getWeights() : weights;
+	repaint();
+}
+
+void AmplitudePdfEditor::paint(juce::Graphics& g)
+{
+	g.setColour(findColour(juce::Slider::rotarySliderOutlineColourId));
+	g.fillRect(getLocalBounds());
+
+	if (m_weights.empty())
+		return;
+
+	// Tallest bar fills the height
+	const float peak = *std::max_element(m_weights.begin(), m_weights.end());
+	if (peak <= 0.0f)
+		return;
+
+	const float width = (float)getWidth() / (float)m_weights.size();
+	const float height = (float)getHeight();
+
+	g.setColour(findColour(juce::Slider::thumbColourId));
+
+	for (size_t bin = 0; bin < m_weights.size(); bin++)
+	{
+		const float barHeight = height * juce::jmax(m_weights[bin], 0.0f) / peak;
+		g.fillRect(juce::Rectangle<float>((float)bin * width, height - barHeight, width, barHeight));
+	}
+}
+
+//==============================================================================
+void AmplitudePdfEditor::mouseDown(const juce::MouseEvent& event)
+{
+	resampleBins();
+
+	m_lastPosition = event.position;
+	draw(event.position);
+}
+
+void AmplitudePdfEditor::mouseDrag(const juce::MouseEvent& event)
+{
+	draw(event.position);
+}
+
+void AmplitudePdfEditor::mouseUp(const juce::MouseEvent&)
+{
+	if (onChange)
+		onChange(m_weights);
+}
+
+void AmplitudePdfEditor::mouseDoubleClick(const juce::MouseEvent&)
+{
+	setWeights({});
+
+	if (onChange)
+		onChange({});
+}
+
+//==============================================================================
+// Loaded or default PDFs may have any number of bins, drawing needs NUM_BINS
+void AmplitudePdfEditor::resampleBins()
+{
+	if (m_weights.size() == (size_t)NUM_BINS)
+		return;
+
+	const float peak = m_weights.empty() ? 0.0f : *std::max_element(m_weights.begin(), m_weights.end());
+
+	std::vector<float> weights((size_t)NUM_BINS, 1.0f);
+	if (peak > 0.0f)
+	{
+		for (int bin = 0; bin < NUM_BINS; bin++)
+		{
+			const size_t source = (size_t)((bin + 0.5f) * (float)m_weights.size() / (float)NUM_BINS);
+			weights[(size_t)bin] = juce::jmax(m_weights[source], 0.0f) / peak;
+		}
+	}
+
+	m_weights = weights;
+}
+
+// Sets every bar between the last and the current mouse position, so fast
+// strokes leave no gaps. Heights are relative, 1 at the top.
+void AmplitudePdfEditor::draw(juce::Point<float> position)
+{
+	const float width = (float)getWidth() / (float)NUM_BINS;
+	const float height = (float)juce::jmax(getHeight(), 1);
+
+	const int first = juce::jlimit(0, NUM_BINS - 1, (int)(juce::jmin(m_lastPosition.x, position.x) / width));
+	const int last = juce::jlimit(0, NUM_BINS - 1, (int)(juce::jmax(m_lastPosition.x, position.x) / width));
+
+	for (int bin = first; bin <= last; bin++)
+	{
+		const float x = ((float)bin + 0.5f) * width;
+		const float span = position.x - m_lastPosition.x;
+		const float fraction = span != 0.0f ? juce::jlimit(0.0f, 1.0f, (x - m_lastPosition.x) / span) : 1.0f;
+		const float y = m_lastPosition.y + fraction * (position.y - m_lastPosition.y);
+
+		m_weights[(size_t)bin] = juce::jlimit(0.0f, 1.0f, 1.0f - y / height);
+	}
+
+	m_lastPosition = position;
+	repaint();
+}
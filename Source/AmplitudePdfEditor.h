@@ -0,0 +1,47 @@
+/*
+  ==============================================================================
+
+    AmplitudePdfEditor.h
+    Created: 18 Oct 2026 4:12:36pm
+    Author:  zazz
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "NoiseGenerator.h"
+
+//==============================================================================
+// Bar graph of an amplitude PDF over [-1, 1). Dragging draws new bar heights,
+// the result is passed on when the mouse is released, a double click restores
+// the default shape.
+class AmplitudePdfEditor : public juce::Component
+{
+public:
+	AmplitudePdfEditor() {};
+
+	static const int NUM_BINS = 64;
+
+	// Empty weights show the default shape
+	void setWeights(const std::vector<float>& weights);
+
+	std::function<void(const std::vector<float>&)> onChange;
+
+	void paint(juce::Graphics& g) override;
+
+	void mouseDown(const juce::MouseEvent& event) override;
+	void mouseDrag(const juce::MouseEvent& event) override;
+	void mouseUp(const juce::MouseEvent& event) override;
+	void mouseDoubleClick(const juce::MouseEvent& event) override;
+
+private:
+	void resampleBins();
+	void draw(juce::Point<float> position);
+
+	std::vector<float> m_weights;
+	juce::Point<float> m_lastPosition;
+
+	JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(AmplitudePdfEditor)
+};
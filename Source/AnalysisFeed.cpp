@@ -0,0 +1,230 @@
+/*
+  ==============================================================================
+
+    AnalysisFeed.cpp
+    Created: 18 Oct 2026 5:26:44pm
+    Author:  zazz
+
+  ==============================================================================
+*/
+
+#include "AnalysisFeed.h"
+#include "RealtimeGuard.h"
+
+//==============================================================================
+AnalysisFeed::AnalysisFeed() : juce::Thread("Analysis Feed")
+{
+}
+
+AnalysisFeed::~AnalysisFeed()
+{
+	release();
+}
+
+void AnalysisFeed::prepare(double sampleRate)
+{
+	release();
+
+	m_ring.assign((size_t)FIFO_SIZE, 0.0f);
+	m_fifo.reset();
+
+	m_window.resize((size_t)FFT_SIZE);
+	for (int i = 0; i < FFT_SIZE; i++)
+	{
+		m_window[(size_t)i] = (float)(0.5 - 0.5 * cos(2.0 * juce::MathConstants<double>::pi * i / FFT_SIZE));
+	}
+
+	m_input.assign((size_t)FFT_SIZE, 0.0f);
+	m_frame.resize((size_t)FFT_SIZE);
+	m_power.assign((size_t)(FFT_SIZE / 2 + 1), 0.0);
+	m_inputFill = 0;
+
+	std::fill(std::begin(m_histogram), std::end(m_histogram), 0.0);
+	m_meanSquare = 0.0;
+
+	// FFT bin shown at each display point
+	const double nyquist = 0.5 * sampleRate;
+	m_pointBins.resize((size_t)SPECTRUM_POINTS + 1);
+	for (int point = 0; point <= SPECTRUM_POINTS; point++)
+	{
+		const double frequency = MIN_FREQUENCY * pow(nyquist / MIN_FREQUENCY, (double)point / SPECTRUM_POINTS);
+		m_pointBins[(size_t)point] = juce::jlimit(1, FFT_SIZE / 2, (int)(frequency * FFT_SIZE / sampleRate));
+	}
+
+	startThread(juce::Thread::Priority::low);
+}
+
+void AnalysisFeed::release()
+{
+	stopThread(1000);
+}
+
+void AnalysisFeed::setActive(bool active)
+{
+	m_active.store(active, std::memory_order_relaxed);
+	if (active)
+		notify();
+}
+
+template <typename SampleType>
+void AnalysisFeed::push(const SampleType* data, int numSamples)
+{
+	if (!m_active.load(std::memory_order_relaxed))
+		return;
+
+	int start1, size1, start2, size2;
+	m_fifo.prepareToWrite(numSamples, start1, size1, start2, size2);
+
+	for (int i = 0; i < size1; i++)
+	{
+		m_ring[(size_t)(start1 + i)] = (float)data[i];
+	}
+	for (int i = 0; i < size2; i++)
+	{
+		m_ring[(size_t)(start2 + i)] = (float)data[size1 + i];
+	}
+
+	m_fifo.finishedWrite(size1 + size2);
+}
+
+template void AnalysisFeed::push<float>(const float* data, int numSamples);
+template void AnalysisFeed::push<double>(const double* data, int numSamples);
+
+bool AnalysisFeed::getSnapshot(Snapshot& snapshot, uint32_t& version) const
+{
+	const uint32_t current = m_version.load(std::memory_order_acquire);
+	if (current == version)
+		return false;
+
+	const RealtimeGuard::ScopedLock lock(m_snapshotLock);
+	snapshot = m_snapshot;
+	version = current;
+
+	return true;
+}
+
+//==============================================================================
+void AnalysisFeed::run()
+{
+	while (!threadShouldExit())
+	{
+		if (!m_active.load(std::memory_order_relaxed))
+		{
+			// Whatever is left is stale once the editor opens again
+			m_fifo.finishedRead(m_fifo.getNumReady());
+			wait(-1);
+			continue;
+		}
+
+		const int ready = m_fifo.getNumReady();
+		if (ready > 0)
+		{
+			int start1, size1, start2, size2;
+			m_fifo.prepareToRead(ready, start1, size1, start2, size2);
+
+			analyse(m_ring.data() + start1, size1);
+			analyse(m_ring.data() + start2, size2);
+
+			m_fifo.finishedRead(size1 + size2);
+			publish();
+		}
+
+		wait(ANALYSIS_INTERVAL_MS);
+	}
+}
+
+// Everything is averaged once per hop of half a frame, whatever the block size
+void AnalysisFeed::analyse(const float* data, int numSamples)
+{
+	const int half = FFT_SIZE / 2;
+
+	while (numSamples > 0)
+	{
+		const int count = juce::jmin(numSamples, FFT_SIZE - m_inputFill);
+		std::copy(data, data + count, m_input.data() + m_inputFill);
+
+		data += count;
+		numSamples -= count;
+		m_inputFill += count;
+
+		if (m_inputFill < FFT_SIZE)
+			break;
+
+		// Level of the new hop first, the histogram range follows it
+		const float* hop = m_input.data() + half;
+
+		double sum = 0.0;
+		for (int i = 0; i < half; i++)
+		{
+			sum += (double)hop[i] * hop[i];
+		}
+		m_meanSquare = m_meanSquare > 0.0 ? AVERAGE_DECAY * m_meanSquare + (1.0 - AVERAGE_DECAY) * sum / half : sum / half;
+
+		const float range = HISTOGRAM_RANGE * (float)sqrt(m_meanSquare);
+		if (range > 0.0f)
+		{
+			for (auto& count : m_histogram)
+			{
+				count *= AVERAGE_DECAY;
+			}
+			NoiseAnalysis::histogram(hop, half, -range, range, m_histogram, HISTOGRAM_BINS);
+		}
+
+		// Hann frames at half frame hops
+		for (int i = 0; i < FFT_SIZE; i++)
+		{
+			m_frame[(size_t)i] = std::complex<float>(m_window[(size_t)i] * m_input[(size_t)i], 0.0f);
+		}
+		m_fft.perform(m_frame.data(), false);
+
+		for (size_t bin = 0; bin < m_power.size(); bin++)
+		{
+			m_power[bin] = AVERAGE_DECAY * m_power[bin] + (1.0 - AVERAGE_DECAY) * std::norm(m_frame[bin]);
+		}
+
+		std::copy(m_input.begin() + half, m_input.end(), m_input.begin());
+		m_inputFill = half;
+	}
+}
+
+void AnalysisFeed::publish()
+{
+	Snapshot snapshot;
+
+	const double peak = *std::max_element(std::begin(m_histogram), std::end(m_histogram));
+	for (int bin = 0; bin < HISTOGRAM_BINS && peak > 0.0; bin++)
+	{
+		snapshot.histogram[bin] = (float)(m_histogram[bin] / peak);
+	}
+
+	// Each point averages the bins up to the next one, so the high end is not sparse
+	double mean = 0.0;
+	for (size_t bin = 1; bin < m_power.size(); bin++)
+	{
+		mean += m_power[bin];
+	}
+	mean /= (double)(m_power.size() - 1);
+
+	for (int point = 0; point < SPECTRUM_POINTS; point++)
+	{
+		const int first = m_pointBins[(size_t)point];
+		const int last = juce::jmax(first, m_pointBins[(size_t)point + 1] - 1);
+
+		double power = 0.0;
+		for (int bin = first; bin <= last; bin++)
+		{
+			power += m_power[(size_t)bin];
+		}
+		power /= (double)(last - first + 1);
+
+		snapshot.spectrumDecibels[point] = mean > 0.0 ? (float)(10.0 * log10(power / mean + 1e-12)) : -100.0f;
+	}
+
+	snapshot.rms = (float)sqrt(m_meanSquare);
+
+	{
+		const RealtimeGuard::ScopedLock lock(m_snapshotLock);
+		m_snapshot = snapshot;
+	}
+	m_version.fetch_add(1, std::memory_order_release);
+}
@@ -0,0 +1,89 @@
+/*
+  ==============================================================================
+
+    AnalysisFeed.h
+    Created: 18 Oct 2026 5:26:44pm
+    Author:  zazz
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "NoiseAnalysis.h"
+
+//==============================================================================
+// Amplitude histogram and averaged spectrum of the output for the editor. The
+// audio thread copies samples into a lock free ring and drops what does not fit,
+// a low priority thread does the binning and the FFTs.
+class AnalysisFeed : private juce::Thread
+{
+public:
+	AnalysisFeed();
+	~AnalysisFeed() override;
+
+	static const int HISTOGRAM_BINS = 64;
+	static const int SPECTRUM_POINTS = 128;
+
+	// Histogram spans this many RMS either side of zero
+	static constexpr float HISTOGRAM_RANGE = 4.0f;
+	static constexpr float MIN_FREQUENCY = 20.0f;
+
+	struct Snapshot
+	{
+		// Peak bin is 1
+		float histogram[HISTOGRAM_BINS] = {};
+		// Log spaced from MIN_FREQUENCY to Nyquist, 0 dB is the mean power
+		float spectrumDecibels[SPECTRUM_POINTS] = {};
+		float rms = 0.0f;
+	};
+
+	// Not thread safe, call while the audio thread is stopped
+	void prepare(double sampleRate);
+	void release();
+
+	// Only fed and analysed while an editor is open
+	void setActive(bool active);
+
+	// Audio thread, never waits. Double samples are narrowed on the way in.
+	template <typename SampleType>
+	void push(const SampleType* data, int numSamples);
+
+	// Any thread. Returns false if nothing changed since version.
+	bool getSnapshot(Snapshot& snapshot, uint32_t& version) const;
+
+private:
+	void run() override;
+	void analyse(const float* data, int numSamples);
+	void publish();
+
+	static const int FFT_ORDER = 11;
+	static const int FFT_SIZE = 1 << FFT_ORDER;
+	static const int FIFO_SIZE = 1 << 15;
+	static const int ANALYSIS_INTERVAL_MS = 30;
+
+	// Exponential averaging per update
+	static constexpr double AVERAGE_DECAY = 0.9;
+
+	juce::AbstractFifo m_fifo{ FIFO_SIZE };
+	std::vector<float> m_ring;
+	std::atomic<bool> m_active{ false };
+
+	// Analysis thread only
+	NoiseAnalysis::Fft m_fft{ FFT_ORDER };
+	std::vector<float> m_window;
+	std::vector<float> m_input;
+	std::vector<std::complex<float>> m_frame;
+	std::vector<double> m_power;
+	std::vector<int> m_pointBins;
+	double m_histogram[HISTOGRAM_BINS] = {};
+	double m_meanSquare = 0.0;
+	int m_inputFill = 0;
+
+	juce::CriticalSection m_snapshotLock;
+	Snapshot m_snapshot;
+	std::atomic<uint32_t> m_version{ 0 };
+
+	JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (AnalysisFeed)
+};
@@ -0,0 +1,86 @@
+/*
+  ==============================================================================
+
+    AnalysisView.cpp
+    Created: 18 Oct 2026 5:26:44pm
+    Author:  zazz
+
+  ==============================================================================
+*/
+
+#include "AnalysisView.h"
+
+//==============================================================================
+AnalysisView::AnalysisView(AnalysisFeed& feed) : m_feed(feed)
+{
+	setBufferedToImage(true);
+	setInterceptsMouseClicks(false, false);
+
+	m_feed.setActive(true);
+	startTimerHz(REFRESH_HZ);
+}
+
+AnalysisView::~AnalysisView()
+{
+	stopTimer();
+	m_feed.setActive(false);
+}
+
+void AnalysisView::paint(juce::Graphics& g)
+{
+	g.setColour(findColour(juce::Slider::rotarySliderOutlineColourId));
+	g.fillRect(getLocalBounds());
+
+	g.setColour(findColour(juce::Slider::thumbColourId));
+	g.fillPath(m_histogramPath);
+	g.strokePath(m_spectrumPath, juce::PathStrokeType(1.5f));
+
+	// Divider between the two halves
+	g.drawVerticalLine(getWidth() / 2, 0.0f, (float)getHeight());
+}
+
+void AnalysisView::resized()
+{
+	updatePaths();
+}
+
+//==============================================================================
+void AnalysisView::timerCallback()
+{
+	if (!m_feed.getSnapshot(m_snapshot, m_version))
+		return;
+
+	updatePaths();
+	repaint();
+}
+
+void AnalysisView::updatePaths()
+{
+	const float height = (float)getHeight();
+	const float halfWidth = 0.5f * (float)getWidth();
+
+	// Histogram as bars from the bottom
+	m_histogramPath.clear();
+	const float barWidth = halfWidth / AnalysisFeed::HISTOGRAM_BINS;
+	for (int bin = 0; bin < AnalysisFeed::HISTOGRAM_BINS; bin++)
+	{
+		const float barHeight = height * m_snapshot.histogram[bin];
+		if (barHeight > 0.0f)
+			m_histogramPath.addRectangle((float)bin * barWidth, height - barHeight, barWidth, barHeight);
+	}
+
+	// Spectrum as a line on a log frequency axis
+	m_spectrumPath.clear();
+	const float pointWidth = halfWidth / (AnalysisFeed::SPECTRUM_POINTS - 1);
+	for (int point = 0; point < AnalysisFeed::SPECTRUM_POINTS; point++)
+	{
+		const float decibels = juce::jlimit(SPECTRUM_BOTTOM_DECIBELS, SPECTRUM_TOP_DECIBELS, m_snapshot.spectrumDecibels[point]);
+		const float x = halfWidth + (float)point * pointWidth;
+		const float y = height * (SPECTRUM_TOP_DECIBELS - decibels) / (SPECTRUM_TOP_DECIBELS - SPECTRUM_BOTTOM_DECIBELS);
+
+		if (point == 0)
+			m_spectrumPath.startNewSubPath(x, y);
+		else
+			m_spectrumPath.lineTo(x, y);
+	}
+}
@@ -0,0 +1,47 @@
+/*
+  ==============================================================================
+
+    AnalysisView.h
+    Created: 18 Oct 2026 5:26:44pm
+    Author:  zazz
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "AnalysisFeed.h"
+
+//==============================================================================
+// Histogram on the left, spectrum on the right. Polls the feed at a low rate and
+// only rebuilds its paths and repaints when there is a new snapshot, the drawing
+// itself is cached in an image.
+class AnalysisView : public juce::Component, private juce::Timer
+{
+public:
+	explicit AnalysisView(AnalysisFeed& feed);
+	~AnalysisView() override;
+
+	static const int REFRESH_HZ = 15;
+
+	// Spectrum view spans this range around the mean power
+	static constexpr float SPECTRUM_TOP_DECIBELS = 20.0f;
+	static constexpr float SPECTRUM_BOTTOM_DECIBELS = -40.0f;
+
+	void paint(juce::Graphics& g) override;
+	void resized() override;
+
+private:
+	void timerCallback() override;
+	void updatePaths();
+
+	AnalysisFeed& m_feed;
+	AnalysisFeed::Snapshot m_snapshot;
+	uint32_t m_version = 0;
+
+	juce::Path m_histogramPath;
+	juce::Path m_spectrumPath;
+
+	JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(AnalysisView)
+};
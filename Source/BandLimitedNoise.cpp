@@ -0,0 +1,150 @@
+/*
+  ==============================================================================
+
+    BandLimitedNoise.cpp
+    Created: 18 Oct 2026 7:36:42pm
+    Author:  zazz
+
+  ==============================================================================
+*/
+
+#include "BandLimitedNoise.h"
+
+static const double PI = 3.14159265358979323846;
+
+// Half the width of the Blackman transition band, in cycles per internal sample
+static const double HALF_TRANSITION = 2.75 / PolyphaseInterpolator::TAPS_PER_PHASE;
+
+//==============================================================================
+void PolyphaseInterpolator::prepare(double sampleRate)
+{
+	m_sampleRate = sampleRate;
+	m_coefficients.resize((size_t)(MAX_FACTOR * TAPS_PER_PHASE));
+
+	// Designed again on the next setBandwidth()
+	m_bandwidth = 0.0f;
+}
+
+void PolyphaseInterpolator::setBandwidth(float bandwidth)
+{
+	if (bandwidth == m_bandwidth)
+		return;
+
+	m_bandwidth = bandwidth;
+
+	const int factor = (int)(m_sampleRate / (OVERSAMPLING * bandwidth));
+	const int limited = factor < 1 ? 1 : factor > MAX_FACTOR ? MAX_FACTOR : factor;
+	if (limited != m_factor)
+	{
+		m_factor = limited;
+		m_version++;
+	}
+
+	design();
+}
+
+// Windowed sinc at the output rate, split into factor phases. The cutoff sits
+// half a transition above the bandwidth, but never lets the stop band reach the
+// internal Nyquist, where the phases would stop matching in level.
+void PolyphaseInterpolator::design()
+{
+	const int length = m_factor * TAPS_PER_PHASE;
+	const double internalRate = m_sampleRate / m_factor;
+
+	const double highest = (0.5 - HALF_TRANSITION) * internalRate;
+	const double requested = m_bandwidth + HALF_TRANSITION * internalRate;
+	const double cutoff = (requested < highest ? requested : highest) / m_sampleRate;
+
+	const double centre = 0.5 * (length - 1);
+	double energy = 0.0;
+
+	for (int j = 0; j < length; j++)
+	{
+		const double x = j - centre;
+		const double sinc = x == 0.0 ? 2.0 * cutoff : sin(2.0 * PI * cutoff * x) / (PI * x);
+		const double phase = 2.0 * PI * j / (length > 1 ? length - 1 : 1);
+		const double window = 0.42 - 0.5 * cos(phase) + 0.08 * cos(2.0 * phase);
+
+		const double tap = sinc * window;
+		energy += tap * tap;
+
+		// Tap j belongs to phase j % factor and multiplies the input j / factor back
+		m_coefficients[(size_t)((j % m_factor) * TAPS_PER_PHASE + j / m_factor)] = (float)tap;
+	}
+
+	// Each phase gets about energy / factor of the tap energy per internal sample,
+	// so this keeps the RMS level
+	const float scale = (float)sqrt(m_factor / (energy > 0.0 ? energy : 1.0));
+	for (int i = 0; i < length; i++)
+	{
+		m_coefficients[(size_t)i] *= scale;
+	}
+}
+
+//==============================================================================
+void BandLimitedNoise::prepare(uint32_t seed)
+{
+	m_seed = seed;
+	m_input.resize((size_t)(PolyphaseInterpolator::TAPS_PER_PHASE - 1 + BATCH));
+	m_output.resize((size_t)(BATCH * PolyphaseInterpolator::MAX_FACTOR));
+	m_prepared = false;
+}
+
+void BandLimitedNoise::reset()
+{
+	std::fill(m_input.begin(), m_input.end(), 0.0f);
+	m_readPosition = 0;
+	m_readyEnd = 0;
+}
+
+template <typename SampleType>
+void BandLimitedNoise::process(WhiteNoiseGenerator& generator, const PolyphaseInterpolator& interpolator, SampleType* out, int numSamples, float gain, ColouredNoise::Colour colour, const ColouredNoise::Slope* slope)
+{
+	const int taps = PolyphaseInterpolator::TAPS_PER_PHASE;
+	const int factor = interpolator.getFactor();
+
+	// Colour filters run at the internal rate
+	if (!m_prepared || m_version != interpolator.getVersion())
+	{
+		m_colouredNoise.prepare(interpolator.getInternalRate(), m_seed);
+		m_version = interpolator.getVersion();
+		m_prepared = true;
+		reset();
+	}
+	m_colouredNoise.setColour(colour, slope);
+
+	float* input = m_input.data();
+	float* history = input + taps - 1;
+
+	while (numSamples > 0)
+	{
+		if (m_readPosition == m_readyEnd)
+		{
+			std::copy(input + BATCH, input + BATCH + taps - 1, input);
+
+			generator.processBlock(history, BATCH, 1.0f);
+			if (colour != ColouredNoise::Colour::White)
+				m_colouredNoise.process(history, BATCH);
+
+			NoiseKernels::interpolate(history, BATCH, factor, interpolator.getPhases(), taps, m_output.data());
+
+			m_readPosition = 0;
+			m_readyEnd = BATCH * factor;
+		}
+
+		const int count = numSamples < m_readyEnd - m_readPosition ? numSamples : m_readyEnd - m_readPosition;
+		const float* ready = m_output.data() + m_readPosition;
+
+		for (int i = 0; i < count; i++)
+		{
+			out[i] = (SampleType)(gain * ready[i]);
+		}
+
+		m_readPosition += count;
+		out += count;
+		numSamples -= count;
+	}
+}
+
+template void BandLimitedNoise::process<float>(WhiteNoiseGenerator& generator, const PolyphaseInterpolator& interpolator, float* out, int numSamples, float gain, ColouredNoise::Colour colour, const ColouredNoise::Slope* slope);
+template void BandLimitedNoise::process<double>(WhiteNoiseGenerator& generator, const PolyphaseInterpolator& interpolator, double* out, int numSamples, float gain, ColouredNoise::Colour colour, const ColouredNoise::Slope* slope);
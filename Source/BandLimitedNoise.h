@@ -0,0 +1,103 @@
+/*
+  ==============================================================================
+
+    BandLimitedNoise.h
+    Created: 18 Oct 2026 7:36:42pm
+    Author:  zazz
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "NoiseGenerator.h"
+#include "ColouredNoise.h"
+
+//==============================================================================
+// Low pass interpolation filter, shared by all channels. Noise below the
+// bandwidth is generated at 1 / factor of the sample rate and brought back up by
+// this filter, only changed from the audio thread between blocks. Every output
+// sample only takes the TAPS_PER_PHASE taps of its phase.
+class PolyphaseInterpolator
+{
+public:
+	PolyphaseInterpolator() {};
+
+	static const int TAPS_PER_PHASE = 24;
+	static const int MAX_FACTOR = 64;
+
+	// Internal rate is at least this many times the bandwidth, which leaves room
+	// for the transition band below its Nyquist
+	static constexpr double OVERSAMPLING = 4.0;
+
+	// Allocates for the largest factor, not real time safe
+	void prepare(double sampleRate);
+
+	// Redesigns the filter if the bandwidth changed, no allocation
+	void setBandwidth(float bandwidth);
+
+	int getFactor() const
+	{
+		return m_factor;
+	}
+	double getInternalRate() const
+	{
+		return m_sampleRate / m_factor;
+	}
+	// Changes whenever the factor does
+	uint32_t getVersion() const
+	{
+		return m_version;
+	}
+	// Taps of phase p start at p * TAPS_PER_PHASE, tap k multiplies the input k
+	// samples back
+	const float* getPhases() const
+	{
+		return m_coefficients.data();
+	}
+
+private:
+	void design();
+
+	double m_sampleRate = 48000.0;
+	float m_bandwidth = 0.0f;
+	int m_factor = 1;
+	uint32_t m_version = 0;
+
+	std::vector<float> m_coefficients;
+};
+
+//==============================================================================
+// Band limited noise of one channel. Generation and colour run at the internal
+// rate, so their cost falls with the bandwidth, the interpolator costs the same
+// per output sample whatever the factor. Keeps the RMS level of its input.
+class BandLimitedNoise
+{
+public:
+	BandLimitedNoise() {};
+
+	// Internal samples generated at once
+	static const int BATCH = 32;
+
+	// Allocates, not real time safe
+	void prepare(uint32_t seed);
+
+	// Generator and colour state carry on, a factor change restarts the filter
+	template <typename SampleType>
+	void process(WhiteNoiseGenerator& generator, const PolyphaseInterpolator& interpolator, SampleType* out, int numSamples, float gain, ColouredNoise::Colour colour, const ColouredNoise::Slope* slope);
+
+private:
+	void reset();
+
+	// Internal samples after TAPS_PER_PHASE - 1 of history, and the output of the
+	// last batch still to be read
+	std::vector<float> m_input;
+	std::vector<float> m_output;
+	int m_readPosition = 0;
+	int m_readyEnd = 0;
+
+	ColouredNoise m_colouredNoise;
+	uint32_t m_seed = 0;
+	uint32_t m_version = 0;
+	bool m_prepared = false;
+};
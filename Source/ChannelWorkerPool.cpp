@@ -0,0 +1,149 @@
+/*
+  ==============================================================================
+
+    ChannelWorkerPool.cpp
+    Created: 18 Oct 2026 11:40:51am
+    Author:  zazz
+
+  ==============================================================================
+*/
+
+#include "ChannelWorkerPool.h"
+#include "RealtimeGuard.h"
+
+//==============================================================================
+ChannelWorkerPool::Worker::Worker(ChannelWorkerPool& pool, int index) : juce::Thread("Channel Worker " + juce::String(index)), m_pool(pool)
+{
+}
+
+void ChannelWorkerPool::Worker::run()
+{
+	int idle = 0;
+
+	while (!threadShouldExit())
+	{
+		if (render())
+		{
+			idle = 0;
+		}
+		else if (++idle < SPIN_COUNT)
+		{
+			juce::Thread::yield();
+		}
+		else
+		{
+			wait(1);
+		}
+	}
+}
+
+// Workers render on behalf of the audio thread, waiting while idle is not
+// part of that
+bool ChannelWorkerPool::Worker::render()
+{
+#if NOISE_GENERATOR_REALTIME_CHECKS
+	const RealtimeGuard::Scope realtimeScope;
+#endif
+
+	return m_pool.help();
+}
+
+//==============================================================================
+ChannelWorkerPool::ChannelWorkerPool()
+{
+}
+
+ChannelWorkerPool::~ChannelWorkerPool()
+{
+	release();
+}
+
+void ChannelWorkerPool::prepare(int numWorkers)
+{
+	if (numWorkers == m_workers.size())
+		return;
+
+	release();
+
+	for (int i = 0; i < numWorkers; i++)
+	{
+		m_workers.add(new Worker(*this, i))->startThread(juce::Thread::Priority::high);
+	}
+
+	m_numWorkers.store(numWorkers, std::memory_order_release);
+}
+
+void ChannelWorkerPool::release()
+{
+	// Blocks from here on run inline, a worker still in a job finishes it first
+	m_numWorkers.store(0, std::memory_order_release);
+
+	for (auto* worker : m_workers)
+	{
+		worker->signalThreadShouldExit();
+	}
+
+	for (auto* worker : m_workers)
+	{
+		worker->stopThread(1000);
+	}
+
+	m_workers.clear();
+}
+
+void ChannelWorkerPool::process(Job job, void* context, int numJobs)
+{
+	if (getNumWorkers() == 0)
+	{
+		for (int i = 0; i < numJobs; i++)
+		{
+			job(context, i);
+		}
+		return;
+	}
+
+	// The previous generation is closed, so nothing reads these while they change
+	m_job = job;
+	m_context = context;
+	m_numJobs.store(numJobs, std::memory_order_relaxed);
+	m_finished.store(0, std::memory_order_relaxed);
+
+	m_generation++;
+	m_claim.store((uint64_t)m_generation << 32, std::memory_order_release);
+
+	// Runs every job no worker has claimed, whether the workers are awake,
+	// late or stopping. Only jobs already running on a worker are waited for,
+	// with the CPU given up after a while in case that worker shares the core.
+	help();
+
+	for (int spin = 0; m_finished.load(std::memory_order_acquire) < numJobs; spin++)
+	{
+		if (spin >= WAIT_SPIN_COUNT)
+			juce::Thread::yield();
+	}
+
+	// Late workers fail their claim from here on
+	m_claim.store(((uint64_t)m_generation << 32) | CLOSED, std::memory_order_release);
+}
+
+bool ChannelWorkerPool::help()
+{
+	bool didWork = false;
+	uint64_t claim = m_claim.load(std::memory_order_acquire);
+
+	for (;;)
+	{
+		const uint32_t next = (uint32_t)claim;
+		if (next == CLOSED || next >= (uint32_t)m_numJobs.load(std::memory_order_relaxed))
+			return didWork;
+
+		if (m_claim.compare_exchange_weak(claim, claim + 1, std::memory_order_acq_rel, std::memory_order_acquire))
+		{
+			m_job(m_context, (int)next);
+			m_finished.fetch_add(1, std::memory_order_release);
+
+			didWork = true;
+			claim = m_claim.load(std::memory_order_acquire);
+		}
+	}
+}
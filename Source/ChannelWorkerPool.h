@@ -0,0 +1,77 @@
+/*
+  ==============================================================================
+
+    ChannelWorkerPool.h
+    Created: 18 Oct 2026 11:40:51am
+    Author:  zazz
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+//==============================================================================
+// Spreads independent jobs (one per channel) over preallocated worker threads.
+// The audio thread claims jobs itself as well, so workers that wake up late only
+// cost parallelism, and it never allocates, locks or waits on a worker to start.
+// Workers can be started and stopped while the audio thread is processing.
+class ChannelWorkerPool
+{
+public:
+	typedef void (*Job)(void* context, int index);
+
+	ChannelWorkerPool();
+	~ChannelWorkerPool();
+
+	// Message thread
+	void prepare(int numWorkers);
+	void release();
+
+	// Any thread
+	int getNumWorkers() const
+	{
+		return m_numWorkers.load(std::memory_order_acquire);
+	}
+
+	// Audio thread, runs job(context, index) for every index below numJobs and
+	// returns once all of them have finished
+	void process(Job job, void* context, int numJobs);
+
+private:
+	class Worker : public juce::Thread
+	{
+	public:
+		Worker(ChannelWorkerPool& pool, int index);
+		void run() override;
+
+	private:
+		bool render();
+
+		ChannelWorkerPool& m_pool;
+	};
+
+	// Claims and runs jobs until none are left, returns false if there were none
+	bool help();
+
+	static const uint32_t CLOSED = 0xffffffffu;
+	static const int SPIN_COUNT = 2000;
+
+	// The audio thread yields after this many checks for jobs still running
+	static const int WAIT_SPIN_COUNT = 4000;
+
+	// Generation in the high half, next unclaimed job in the low half
+	std::atomic<uint64_t> m_claim{ CLOSED };
+	std::atomic<int> m_finished{ 0 };
+
+	Job m_job = nullptr;
+	void* m_context = nullptr;
+	std::atomic<int> m_numJobs{ 0 };
+	uint32_t m_generation = 0;
+
+	juce::OwnedArray<Worker> m_workers;
+	std::atomic<int> m_numWorkers{ 0 };
+
+	JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ChannelWorkerPool)
+};
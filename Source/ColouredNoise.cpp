@@ -0,0 +1,481 @@
+/*
+  ==============================================================================
+
+    ColouredNoise.cpp
+    Created: 18 Oct 2026 12:25:08pm
+    Author:  zazz
+
+  ==============================================================================
+*/
+
+#include "ColouredNoise.h"
+
+#include <complex>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+	#define COLOURED_NOISE_SSE2 1
+	#include <emmintrin.h>
+#else
+	#define COLOURED_NOISE_SSE2 0
+#endif
+
+#if defined(_MSC_VER)
+	#include <intrin.h>
+#endif
+
+//==============================================================================
+static inline int countTrailingZeros(uint32_t x)
+{
+#if defined(_MSC_VER)
+	unsigned long index;
+	_BitScanForward(&index, x);
+	return (int)index;
+#else
+	return __builtin_ctz(x);
+#endif
+}
+
+static const double PI = 3.14159265358979323846;
+
+// Band the custom slope is spread over, up to just below Nyquist. The octave
+// below the top frequency is fitted exactly.
+static const double SLOPE_LOW_FREQUENCY = 5.0;
+static const double SLOPE_HIGH_RATIO = 0.49;
+static const double SLOPE_TOP_FREQUENCY = 20000.0;
+static const int SLOPE_FIT_STEPS = 3;
+
+// Pole of the brown integrator
+static const double BROWN_FREQUENCY = 10.0;
+
+// Blue is differentiated pink, only one row and the white term change per sample
+static const float BLUE_GAIN = sqrtf((float)(ColouredNoise::PINK_ROWS + 1) / 4.0f);
+
+// Counter mode rows use the upper half of the streams, white noise the lower
+static const uint32_t ROW_STREAM_OFFSET = 0x80000000u;
+
+// Analog frequency the bilinear transform maps onto frequency
+static double prewarp(double frequency, double sampleRate)
+{
+	return tan(PI * frequency / sampleRate);
+}
+
+// First order section from a prewarped analog zero and pole
+static void firstOrderSection(double wz, double wp, float& b0, float& b1, float& a1)
+{
+	b0 = (float)((1.0 + wz) / (1.0 + wp));
+	b1 = (float)((wz - 1.0) / (1.0 + wp));
+	a1 = (float)((wp - 1.0) / (1.0 + wp));
+}
+
+// dB a falling section with prewarped corners drops from w1 to w2
+static double sectionFall(double wz, double wp, double w1, double w2)
+{
+	return 10.0 * log10((1.0 + w2 * w2 / (wp * wp)) / (1.0 + w1 * w1 / (wp * wp)) * (1.0 + w1 * w1 / (wz * wz)) / (1.0 + w2 * w2 / (wz * wz)));
+}
+
+//==============================================================================
+void ColouredNoise::prepare(double sampleRate, uint32_t seed)
+{
+	m_random = seed * 2u + 1u;
+
+	m_leak = (float)exp(-2.0 * PI * BROWN_FREQUENCY / sampleRate);
+	m_brownGain = sqrtf(1.0f - m_leak * m_leak);
+
+	reset();
+}
+
+void ColouredNoise::reset()
+{
+	for (int k = 0; k < PINK_ROWS; k++)
+	{
+		m_rows[k] = 0.0f;
+	}
+	m_rowSum = 0.0f;
+	m_counter = 0;
+	m_rowsPosition = NO_POSITION;
+	m_filtersPosition = NO_POSITION;
+
+	resetFilters();
+}
+
+void ColouredNoise::resetFilters()
+{
+	m_brown = 0.0f;
+	m_previous = 0.0f;
+
+	for (int k = 0; k < SLOPE_STAGES; k++)
+	{
+		m_x1[k] = 0.0f;
+		m_y1[k] = 0.0f;
+	}
+	m_extraX1 = 0.0f;
+	m_extraY1 = 0.0f;
+}
+
+void ColouredNoise::setColour(Colour colour, const Slope* slope)
+{
+	m_colour = colour;
+	m_slope = slope;
+}
+
+void ColouredNoise::setCounterKey(uint32_t seed, uint32_t stream)
+{
+	const uint32_t* key = m_counterGenerator.getKey();
+	if (key[0] == seed && key[1] == stream + ROW_STREAM_OFFSET)
+		return;
+
+	m_counterGenerator.setKey(seed, stream + ROW_STREAM_OFFSET);
+	m_rowsPosition = NO_POSITION;
+}
+
+// Rows as they are after position - 1. Row k was last refreshed at the latest
+// position below that has 2^k as its low k + 1 bits.
+void ColouredNoise::seekRows(uint64_t position)
+{
+	m_rowSum = 0.0f;
+
+	for (int k = 0; k < PINK_ROWS; k++)
+	{
+		const uint64_t offset = 1ull << k;
+		m_rows[k] = 0.0f;
+
+		if (position > offset)
+		{
+			const uint64_t refresh = ((position - 1u - offset) >> (k + 1) << (k + 1)) + offset;
+
+			uint32_t bits;
+			m_counterGenerator.processBits(refresh, &bits, 1);
+			m_rows[k] = NoiseKernels::bitsToFloat(bits);
+		}
+
+		m_rowSum += m_rows[k];
+	}
+}
+
+//==============================================================================
+void ColouredNoise::Slope::design(double newSampleRate, float newSlope)
+{
+	if (newSampleRate == sampleRate && newSlope == slope)
+		return;
+
+	sampleRate = newSampleRate;
+	slope = newSlope;
+
+	const double highFrequency = SLOPE_HIGH_RATIO * sampleRate;
+	const double topFrequency = SLOPE_TOP_FREQUENCY < highFrequency ? SLOPE_TOP_FREQUENCY : highFrequency;
+	const double ratio = pow(highFrequency / SLOPE_LOW_FREQUENCY, 1.0 / SLOPE_STAGES);
+	const double low = prewarp(SLOPE_LOW_FREQUENCY, sampleRate);
+
+	// The top octave, which the bilinear transform stretches the most
+	const double w1 = prewarp(0.5 * topFrequency, sampleRate);
+	const double w2 = prewarp(topFrequency, sampleRate);
+
+	const double clamped = slope < -MAX_SLOPE ? -MAX_SLOPE : slope > MAX_SLOPE ? MAX_SLOPE : slope;
+	double remaining = clamped;
+
+	// A whole band of +-6 dB per octave. A far corner at the top of the band
+	// would fall faster over the top octave, so it is placed where that octave
+	// falls exactly 6 dB.
+	double extraFall = 0.0;
+	if (fabs(remaining) > 6.0)
+	{
+		// The low corner alone gives more than the power ratio of 4 over that
+		// octave, the far corner's share brings it back to 4
+		const double lowRatio = (1.0 + w2 * w2 / (low * low)) / (1.0 + w1 * w1 / (low * low));
+		const double farRatio = 4.0 / lowRatio;
+		const double farCorner = sqrt((w1 * w1 - farRatio * w2 * w2) / (farRatio - 1.0));
+
+		if (remaining < 0.0)
+		{
+			firstOrderSection(farCorner, low, extraB0, extraB1, extraA1);
+			remaining += 6.0;
+		}
+		else
+		{
+			firstOrderSection(low, farCorner, extraB0, extraB1, extraA1);
+			remaining -= 6.0;
+		}
+
+		extraFall = sectionFall(farCorner, low, w1, w2);
+	}
+	else
+	{
+		extraB0 = 1.0f;
+		extraB1 = 0.0f;
+		extraA1 = 0.0f;
+	}
+
+	// Each section falls (or rises) 6 dB per octave over a fraction of its share
+	// of the band, taken on the prewarped axis
+	double first[SLOPE_STAGES];
+	double second[SLOPE_STAGES];
+	for (int k = 0; k < SLOPE_STAGES; k++)
+	{
+		first[k] = prewarp(SLOPE_LOW_FREQUENCY * pow(ratio, k), sampleRate);
+		second[k] = first[k] * pow(ratio, fabs(remaining) / 6.0);
+	}
+
+	// The cascade runs out at the top of the band and the top octave comes out
+	// flat, so the last section's spacing is fitted to it with a few Newton steps
+	if (remaining != 0.0)
+	{
+		const int last = SLOPE_STAGES - 1;
+		const double target = fabs(clamped) - extraFall;
+
+		double others = 0.0;
+		for (int k = 0; k < last; k++)
+			others += sectionFall(second[k], first[k], w1, w2);
+
+		double spacing = log(second[last] / first[last]);
+		for (int step = 0; step < SLOPE_FIT_STEPS; step++)
+		{
+			const double delta = 1.0e-4;
+			const double error = others + sectionFall(first[last] * exp(spacing), first[last], w1, w2) - target;
+			const double slopeOfError = (others + sectionFall(first[last] * exp(spacing + delta), first[last], w1, w2) - target - error) / delta;
+			if (slopeOfError <= 0.0)
+				break;
+
+			spacing -= error / slopeOfError;
+			spacing = spacing < 0.0 ? 0.0 : spacing;
+		}
+
+		second[last] = first[last] * exp(spacing);
+	}
+
+	for (int k = 0; k < SLOPE_STAGES; k++)
+	{
+		if (remaining < 0.0)
+			firstOrderSection(second[k], first[k], b0[k], b1[k], a1[k]);
+		else
+			firstOrderSection(first[k], second[k], b0[k], b1[k], a1[k]);
+	}
+
+	// Unity power gain for white input, integrated on a log frequency grid as
+	// steep negative slopes put most of the power at the bottom
+	const int points = 512;
+	const double lowest = 0.01 / sampleRate;
+	const double step = log(0.5 / lowest) / points;
+	double power = 0.0;
+	for (int i = 0; i < points; i++)
+	{
+		const double frequency = lowest * exp((i + 0.5) * step);
+		const std::complex<double> zInverse = std::polar(1.0, -2.0 * PI * frequency);
+
+		std::complex<double> response = ((double)extraB0 + (double)extraB1 * zInverse) / (1.0 + (double)extraA1 * zInverse);
+		for (int k = 0; k < SLOPE_STAGES; k++)
+		{
+			response *= ((double)b0[k] + (double)b1[k] * zInverse) / (1.0 + (double)a1[k] * zInverse);
+		}
+
+		power += std::norm(response) * frequency * step;
+	}
+
+	const float normalise = (float)sqrt(0.5 / power);
+	extraB0 *= normalise;
+	extraB1 *= normalise;
+}
+
+//==============================================================================
+template <typename SampleType>
+void ColouredNoise::process(SampleType* data, int numSamples)
+{
+	m_rowsPosition = NO_POSITION;
+	m_filtersPosition = NO_POSITION;
+
+	switch (m_colour)
+	{
+	case Colour::Pink:		processPink(data, numSamples); break;
+	case Colour::Brown:		processBrown(data, numSamples); break;
+	case Colour::Blue:		processPink(data, numSamples); differentiate(data, numSamples, BLUE_GAIN); break;
+	case Colour::Violet:	differentiate(data, numSamples, sqrtf(0.5f)); break;
+	case Colour::Custom:	if (m_slope != nullptr) processCustom(data, numSamples); break;
+	default:				break;
+	}
+}
+
+template <typename SampleType>
+void ColouredNoise::processAt(uint64_t position, SampleType* data, int numSamples)
+{
+	if (position != m_filtersPosition)
+		resetFilters();
+	m_filtersPosition = position + (uint64_t)numSamples;
+
+	switch (m_colour)
+	{
+	case Colour::Pink:		processPinkAt(position, data, numSamples); break;
+	case Colour::Brown:		processBrown(data, numSamples); break;
+	case Colour::Blue:		processPinkAt(position, data, numSamples); differentiate(data, numSamples, BLUE_GAIN); break;
+	case Colour::Violet:	differentiate(data, numSamples, sqrtf(0.5f)); break;
+	case Colour::Custom:	if (m_slope != nullptr) processCustom(data, numSamples); break;
+	default:				break;
+	}
+}
+
+template <typename SampleType>
+void ColouredNoise::processPink(SampleType* data, int numSamples)
+{
+	// Rows plus the white input, each with roughly the input variance
+	const float gain = 1.0f / sqrtf((float)(PINK_ROWS + 1));
+	const uint32_t counterMask = (1u << PINK_ROWS) - 1u;
+
+	for (int i = 0; i < numSamples; i++)
+	{
+		m_counter = (m_counter + 1u) & counterMask;
+
+		if (m_counter != 0)
+		{
+			const int row = countTrailingZeros(m_counter);
+
+			m_random = 1664525u * m_random + 1013904223u;
+			const float value = NoiseKernels::bitsToFloat(m_random);
+
+			m_rowSum += value - m_rows[row];
+			m_rows[row] = value;
+		}
+		else
+		{
+			// Stops rounding errors in the running sum from drifting
+			m_rowSum = 0.0f;
+			for (int row = 0; row < PINK_ROWS; row++)
+			{
+				m_rowSum += m_rows[row];
+			}
+		}
+
+		data[i] = (SampleType)(gain * (m_rowSum + (float)data[i]));
+	}
+}
+
+template <typename SampleType>
+void ColouredNoise::processPinkAt(uint64_t position, SampleType* data, int numSamples)
+{
+	const float gain = 1.0f / sqrtf((float)(PINK_ROWS + 1));
+	const uint32_t counterMask = (1u << PINK_ROWS) - 1u;
+
+	if (position != m_rowsPosition)
+		seekRows(position);
+	m_rowsPosition = position + (uint64_t)numSamples;
+
+	uint32_t words[COUNTER_BLOCK];
+	for (int start = 0; start < numSamples; start += COUNTER_BLOCK)
+	{
+		const int count = numSamples - start < COUNTER_BLOCK ? numSamples - start : COUNTER_BLOCK;
+		m_counterGenerator.processBits(position + (uint64_t)start, words, count);
+
+		for (int i = 0; i < count; i++)
+		{
+			const uint32_t counter = (uint32_t)(position + (uint64_t)(start + i)) & counterMask;
+
+			if (counter != 0)
+			{
+				const int row = countTrailingZeros(counter);
+				const float value = NoiseKernels::bitsToFloat(words[i]);
+
+				m_rowSum += value - m_rows[row];
+				m_rows[row] = value;
+			}
+			else
+			{
+				m_rowSum = 0.0f;
+				for (int row = 0; row < PINK_ROWS; row++)
+				{
+					m_rowSum += m_rows[row];
+				}
+			}
+
+			data[start + i] = (SampleType)(gain * (m_rowSum + (float)data[start + i]));
+		}
+	}
+}
+
+template <typename SampleType>
+void ColouredNoise::processBrown(SampleType* data, int numSamples)
+{
+	for (int i = 0; i < numSamples; i++)
+	{
+		m_brown = m_leak * m_brown + m_brownGain * (float)data[i];
+		data[i] = m_brown;
+	}
+}
+
+template <typename SampleType>
+void ColouredNoise::differentiate(SampleType* data, int numSamples, float gain)
+{
+	for (int i = 0; i < numSamples; i++)
+	{
+		const float current = (float)data[i];
+		data[i] = gain * (current - m_previous);
+		m_previous = current;
+	}
+}
+
+template <typename SampleType>
+void ColouredNoise::processCustom(SampleType* data, int numSamples)
+{
+	const Slope& slope = *m_slope;
+
+	// The output lags the input by SLOPE_STAGES - 1 samples, which does not matter for noise
+	for (int i = 0; i < numSamples; i++)
+	{
+		const float input = (float)data[i];
+		const float extra = slope.extraB0 * input + slope.extraB1 * m_extraX1 - slope.extraA1 * m_extraY1;
+		m_extraX1 = input;
+		m_extraY1 = extra;
+		data[i] = extra;
+	}
+
+#if COLOURED_NOISE_SSE2
+	const __m128 b0Low = _mm_loadu_ps(slope.b0);
+	const __m128 b0High = _mm_loadu_ps(slope.b0 + 4);
+	const __m128 b1Low = _mm_loadu_ps(slope.b1);
+	const __m128 b1High = _mm_loadu_ps(slope.b1 + 4);
+	const __m128 a1Low = _mm_loadu_ps(slope.a1);
+	const __m128 a1High = _mm_loadu_ps(slope.a1 + 4);
+
+	__m128 x1Low = _mm_loadu_ps(m_x1);
+	__m128 x1High = _mm_loadu_ps(m_x1 + 4);
+	__m128 y1Low = _mm_loadu_ps(m_y1);
+	__m128 y1High = _mm_loadu_ps(m_y1 + 4);
+
+	for (int i = 0; i < numSamples; i++)
+	{
+		// Stage k takes the previous output of stage k - 1, stage 0 takes the new sample
+		const __m128 inLow = _mm_move_ss(_mm_castsi128_ps(_mm_slli_si128(_mm_castps_si128(y1Low), 4)), _mm_set_ss((float)data[i]));
+		const __m128 inHigh = _mm_castsi128_ps(_mm_or_si128(_mm_slli_si128(_mm_castps_si128(y1High), 4), _mm_srli_si128(_mm_castps_si128(y1Low), 12)));
+
+		y1Low = _mm_sub_ps(_mm_add_ps(_mm_mul_ps(b0Low, inLow), _mm_mul_ps(b1Low, x1Low)), _mm_mul_ps(a1Low, y1Low));
+		y1High = _mm_sub_ps(_mm_add_ps(_mm_mul_ps(b0High, inHigh), _mm_mul_ps(b1High, x1High)), _mm_mul_ps(a1High, y1High));
+		x1Low = inLow;
+		x1High = inHigh;
+
+		data[i] = _mm_cvtss_f32(_mm_shuffle_ps(y1High, y1High, _MM_SHUFFLE(3, 3, 3, 3)));
+	}
+
+	_mm_storeu_ps(m_x1, x1Low);
+	_mm_storeu_ps(m_x1 + 4, x1High);
+	_mm_storeu_ps(m_y1, y1Low);
+	_mm_storeu_ps(m_y1 + 4, y1High);
+#else
+	for (int i = 0; i < numSamples; i++)
+	{
+		float input = (float)data[i];
+
+		for (int k = 0; k < SLOPE_STAGES; k++)
+		{
+			// Stage k + 1 gets the output stage k had before this step
+			const float previousOutput = m_y1[k];
+			m_y1[k] = slope.b0[k] * input + slope.b1[k] * m_x1[k] - slope.a1[k] * m_y1[k];
+			m_x1[k] = input;
+			input = previousOutput;
+		}
+
+		data[i] = m_y1[SLOPE_STAGES - 1];
+	}
+#endif
+}
+
+// Filters run in float whatever the sample type, double only saves the conversion
+template void ColouredNoise::process<float>(float* data, int numSamples);
+template void ColouredNoise::process<double>(double* data, int numSamples);
+template void ColouredNoise::processAt<float>(uint64_t position, float* data, int numSamples);
+template void ColouredNoise::processAt<double>(uint64_t position, double* data, int numSamples);
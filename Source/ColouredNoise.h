@@ -0,0 +1,129 @@
+/*
+  ==============================================================================
+
+    ColouredNoise.h
+    Created: 18 Oct 2026 12:25:08pm
+    Author:  zazz
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "NoiseGenerator.h"
+
+//==============================================================================
+// Shapes a block of unity level white noise in place. Every colour keeps about
+// the RMS level of its input.
+class ColouredNoise
+{
+public:
+	ColouredNoise() {};
+
+	enum Colour
+	{
+		White,
+		Pink,
+		Brown,
+		Blue,
+		Violet,
+		Custom
+	};
+
+	static const int PINK_ROWS = 16;
+	static const int SLOPE_STAGES = 8;
+
+	// Custom slopes are limited to this many dB per octave either way
+	static constexpr float MAX_SLOPE = 12.0f;
+
+	//==============================================================================
+	// Custom slope, first order shelves with log spaced poles plus one extra
+	// section for slopes steeper than 6 dB per octave. Designed once per block
+	// and read by every channel running at its sample rate.
+	struct Slope
+	{
+		// Only redesigns when either changed, no allocation
+		void design(double sampleRate, float slope);
+
+		float b0[SLOPE_STAGES] = {};
+		float b1[SLOPE_STAGES] = {};
+		float a1[SLOPE_STAGES] = {};
+
+		float extraB0 = 1.0f;
+		float extraB1 = 0.0f;
+		float extraA1 = 0.0f;
+
+		double sampleRate = 0.0;
+		float slope = 0.0f;
+	};
+
+	//==============================================================================
+	void prepare(double sampleRate, uint32_t seed);
+	void reset();
+
+	// Custom reads the slope while processing, it has to outlive that
+	void setColour(Colour colour, const Slope* slope);
+	Colour getColour() const
+	{
+		return m_colour;
+	}
+
+	// Float or double
+	template <typename SampleType>
+	void process(SampleType* data, int numSamples);
+
+	// Counter mode, the pink rows are a function of the position and key alone.
+	// Filter states start again wherever the position jumps.
+	void setCounterKey(uint32_t seed, uint32_t stream);
+	template <typename SampleType>
+	void processAt(uint64_t position, SampleType* data, int numSamples);
+
+private:
+	template <typename SampleType>
+	void processPink(SampleType* data, int numSamples);
+	template <typename SampleType>
+	void processPinkAt(uint64_t position, SampleType* data, int numSamples);
+	template <typename SampleType>
+	void processBrown(SampleType* data, int numSamples);
+	template <typename SampleType>
+	void differentiate(SampleType* data, int numSamples, float gain);
+	template <typename SampleType>
+	void processCustom(SampleType* data, int numSamples);
+
+	void resetFilters();
+	void seekRows(uint64_t position);
+
+	// Counter mode words are generated this many at a time
+	static const int COUNTER_BLOCK = 64;
+	static const uint64_t NO_POSITION = ~(uint64_t)0;
+
+	Colour m_colour = Colour::White;
+	const Slope* m_slope = nullptr;
+
+	// Voss-McCartney rows, row k is refreshed every 2^(k + 1) samples
+	float m_rows[PINK_ROWS] = {};
+	float m_rowSum = 0.0f;
+	uint32_t m_counter = 0;
+	uint32_t m_random = 1;
+
+	// Counter mode, row refreshed at position n takes word n. Positions the
+	// rows and the filters continue from, NO_POSITION after free running.
+	Philox m_counterGenerator;
+	uint64_t m_rowsPosition = NO_POSITION;
+	uint64_t m_filtersPosition = NO_POSITION;
+
+	// Leaky integrator
+	float m_brown = 0.0f;
+	float m_leak = 0.999f;
+	float m_brownGain = 0.045f;
+
+	// Last input of the differentiators
+	float m_previous = 0.0f;
+
+	// Custom slope states, the stages run as a pipeline, stage k works on the
+	// sample k steps behind stage 0
+	float m_x1[SLOPE_STAGES] = {};
+	float m_y1[SLOPE_STAGES] = {};
+	float m_extraX1 = 0.0f;
+	float m_extraY1 = 0.0f;
+};
@@ -0,0 +1,187 @@
+/*
+  ==============================================================================
+
+    DspLoadMeter.cpp
+    Created: 18 Oct 2026 2:10:22pm
+    Author:  zazz
+
+  ==============================================================================
+*/
+
+#include "DspLoadMeter.h"
+
+#if NOISE_GENERATOR_PROFILING
+
+//==============================================================================
+static inline int highestBit(uint64_t x)
+{
+#if defined(_MSC_VER) && defined(_M_X64)
+	unsigned long index;
+	_BitScanReverse64(&index, x);
+	return (int)index;
+#elif defined(_MSC_VER)
+	unsigned long index;
+	if (_BitScanReverse(&index, (unsigned long)(x >> 32)))
+		return (int)index + 32;
+	_BitScanReverse(&index, (unsigned long)x);
+	return (int)index;
+#else
+	return 63 - __builtin_clzll(x);
+#endif
+}
+
+//==============================================================================
+void DspLoadMeter::prepare(double sampleRate)
+{
+	m_sampleRate = sampleRate;
+	reset();
+
+	m_referenceTicks = now();
+	m_referenceTime = std::chrono::steady_clock::now();
+}
+
+void DspLoadMeter::end(uint64_t start, int numSamples)
+{
+	if (m_resetRequested.exchange(false, std::memory_order_relaxed))
+	{
+		for (auto& bin : m_bins)
+		{
+			bin.store(0, std::memory_order_relaxed);
+		}
+		m_blocks.store(0, std::memory_order_relaxed);
+		m_samples.store(0, std::memory_order_relaxed);
+		m_ticks.store(0, std::memory_order_relaxed);
+		m_worstTicks.store(0, std::memory_order_relaxed);
+	}
+
+	// Single writer, plain load and store instead of read-modify-write
+	const uint64_t ticks = now() - start;
+	auto& bin = m_bins[getBin(ticks)];
+
+	bin.store(bin.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+	m_samples.store(m_samples.load(std::memory_order_relaxed) + (uint64_t)numSamples, std::memory_order_relaxed);
+	m_ticks.store(m_ticks.load(std::memory_order_relaxed) + ticks, std::memory_order_relaxed);
+
+	if (ticks > m_worstTicks.load(std::memory_order_relaxed))
+		m_worstTicks.store(ticks, std::memory_order_relaxed);
+
+	// Published last, so a reader never sees more blocks than samples and ticks
+	m_blocks.store(m_blocks.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+}
+
+//==============================================================================
+// Linear below BINS_PER_OCTAVE ticks, then BINS_PER_OCTAVE bins per octave
+int DspLoadMeter::getBin(uint64_t ticks)
+{
+	if (ticks < BINS_PER_OCTAVE)
+		return (int)ticks;
+
+	const int exponent = highestBit(ticks);
+	const int mantissa = (int)(ticks >> (exponent - BINS_PER_OCTAVE_LOG2)) & (BINS_PER_OCTAVE - 1);
+	const int bin = (exponent - BINS_PER_OCTAVE_LOG2 + 1) * BINS_PER_OCTAVE + mantissa;
+
+	return bin < NUM_BINS ? bin : NUM_BINS - 1;
+}
+
+uint64_t DspLoadMeter::getBinUpperTicks(int bin)
+{
+	if (bin < BINS_PER_OCTAVE)
+		return (uint64_t)bin + 1;
+
+	const int exponent = bin / BINS_PER_OCTAVE + BINS_PER_OCTAVE_LOG2 - 1;
+	const uint64_t mantissa = (uint64_t)(bin % BINS_PER_OCTAVE);
+
+	return (BINS_PER_OCTAVE + mantissa + 1) << (exponent - BINS_PER_OCTAVE_LOG2);
+}
+
+double DspLoadMeter::getNanosecondsPerTick() const
+{
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86)) || defined(__x86_64__) || defined(__i386__)
+	const uint64_t ticks = now() - m_referenceTicks;
+	const double nanoseconds = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - m_referenceTime).count();
+
+	return ticks > 0 ? nanoseconds / (double)ticks : 0.0;
+#else
+	return 1.0e9 * std::chrono::steady_clock::period::num / std::chrono::steady_clock::period::den;
+#endif
+}
+
+double DspLoadMeter::getPercentile(const uint64_t* counts, uint64_t total, double fraction, double nanosecondsPerTick) const
+{
+	const uint64_t target = (uint64_t)std::ceil(fraction * (double)total);
+	uint64_t sum = 0;
+
+	for (int bin = 0; bin < NUM_BINS; bin++)
+	{
+		sum += counts[bin];
+		if (sum >= target && sum > 0)
+			return nanosecondsPerTick * (double)getBinUpperTicks(bin);
+	}
+
+	return 0.0;
+}
+
+DspLoadMeter::Snapshot DspLoadMeter::getSnapshot() const
+{
+	Snapshot snapshot;
+
+	snapshot.blocks = m_blocks.load(std::memory_order_acquire);
+	if (snapshot.blocks == 0)
+		return snapshot;
+
+	uint64_t counts[NUM_BINS];
+	uint64_t total = 0;
+	for (int bin = 0; bin < NUM_BINS; bin++)
+	{
+		counts[bin] = m_bins[bin].load(std::memory_order_relaxed);
+		total += counts[bin];
+	}
+
+	const double nanosecondsPerTick = getNanosecondsPerTick();
+	const double samples = (double)m_samples.load(std::memory_order_relaxed);
+	const double nanoseconds = nanosecondsPerTick * (double)m_ticks.load(std::memory_order_relaxed);
+
+	snapshot.nanosecondsPerSample = samples > 0.0 ? nanoseconds / samples : 0.0;
+	snapshot.meanNanoseconds = nanoseconds / (double)snapshot.blocks;
+	snapshot.worstNanoseconds = nanosecondsPerTick * (double)m_worstTicks.load(std::memory_order_relaxed);
+	snapshot.p50Nanoseconds = getPercentile(counts, total, 0.5, nanosecondsPerTick);
+	snapshot.p99Nanoseconds = getPercentile(counts, total, 0.99, nanosecondsPerTick);
+	snapshot.p999Nanoseconds = getPercentile(counts, total, 0.999, nanosecondsPerTick);
+
+	// Time spent per second of audio
+	snapshot.load = snapshot.nanosecondsPerSample * m_sampleRate * 1.0e-9;
+
+	return snapshot;
+}
+
+juce::Result DspLoadMeter::dumpToFile(const juce::File& file) const
+{
+	const Snapshot snapshot = getSnapshot();
+	const double nanosecondsPerTick = getNanosecondsPerTick();
+
+	juce::String text;
+	text << "blocks," << (juce::int64)snapshot.blocks << "\n"
+		<< "ns per sample," << snapshot.nanosecondsPerSample << "\n"
+		<< "mean ns," << snapshot.meanNanoseconds << "\n"
+		<< "p50 ns," << snapshot.p50Nanoseconds << "\n"
+		<< "p99 ns," << snapshot.p99Nanoseconds << "\n"
+		<< "p99.9 ns," << snapshot.p999Nanoseconds << "\n"
+		<< "worst ns," << snapshot.worstNanoseconds << "\n"
+		<< "load," << snapshot.load << "\n"
+		<< "\n"
+		<< "upper ns,blocks\n";
+
+	for (int bin = 0; bin < NUM_BINS; bin++)
+	{
+		const uint64_t count = m_bins[bin].load(std::memory_order_relaxed);
+		if (count > 0)
+			text << nanosecondsPerTick * (double)getBinUpperTicks(bin) << "," << (juce::int64)count << "\n";
+	}
+
+	if (!file.replaceWithText(text))
+		return juce::Result::fail("Could not write " + file.getFullPathName());
+
+	return juce::Result::ok();
+}
+
+#endif
@@ -0,0 +1,99 @@
+/*
+  ==============================================================================
+
+    DspLoadMeter.h
+    Created: 18 Oct 2026 2:10:22pm
+    Author:  zazz
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+#if defined(_MSC_VER)
+	#include <intrin.h>
+#endif
+
+// Set to 0 to compile the instrumentation out
+#ifndef NOISE_GENERATOR_PROFILING
+	#define NOISE_GENERATOR_PROFILING 1
+#endif
+
+#if NOISE_GENERATOR_PROFILING
+
+//==============================================================================
+// Times processBlock calls in CPU ticks. The audio thread is the only writer and
+// never waits, readers get a close enough view through relaxed loads.
+class DspLoadMeter
+{
+public:
+	DspLoadMeter() {};
+
+	// Each octave of ticks is split into this many bins
+	static const int BINS_PER_OCTAVE_LOG2 = 3;
+	static const int BINS_PER_OCTAVE = 1 << BINS_PER_OCTAVE_LOG2;
+	static const int NUM_BINS = 48 * BINS_PER_OCTAVE;
+
+	struct Snapshot
+	{
+		uint64_t blocks = 0;
+		double nanosecondsPerSample = 0.0;
+		double meanNanoseconds = 0.0;
+		double worstNanoseconds = 0.0;
+		double p50Nanoseconds = 0.0;
+		double p99Nanoseconds = 0.0;
+		double p999Nanoseconds = 0.0;
+
+		// Mean block time over the block period
+		double load = 0.0;
+	};
+
+	// Not thread safe, call while the audio thread is stopped
+	void prepare(double sampleRate);
+
+	// Audio thread
+	static uint64_t now()
+	{
+	#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+		return __rdtsc();
+	#elif defined(__x86_64__) || defined(__i386__)
+		return __builtin_ia32_rdtsc();
+	#else
+		return (uint64_t)std::chrono::steady_clock::now().time_since_epoch().count();
+	#endif
+	}
+	void end(uint64_t start, int numSamples);
+
+	// Any thread, the histogram is cleared by the next audio block
+	void reset()
+	{
+		m_resetRequested.store(true, std::memory_order_relaxed);
+	}
+	Snapshot getSnapshot() const;
+	juce::Result dumpToFile(const juce::File& file) const;
+
+private:
+	static int getBin(uint64_t ticks);
+	static uint64_t getBinUpperTicks(int bin);
+
+	double getNanosecondsPerTick() const;
+	double getPercentile(const uint64_t* counts, uint64_t total, double fraction, double nanosecondsPerTick) const;
+
+	std::atomic<uint64_t> m_bins[NUM_BINS] = {};
+	std::atomic<uint64_t> m_blocks{ 0 };
+	std::atomic<uint64_t> m_samples{ 0 };
+	std::atomic<uint64_t> m_ticks{ 0 };
+	std::atomic<uint64_t> m_worstTicks{ 0 };
+	std::atomic<bool> m_resetRequested{ false };
+
+	// Tick rate is measured against the wall clock since prepare
+	uint64_t m_referenceTicks = 0;
+	std::chrono::steady_clock::time_point m_referenceTime;
+	double m_sampleRate = 48000.0;
+
+	JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (DspLoadMeter)
+};
+
+#endif
@@ -0,0 +1,114 @@
+/*
+  ==============================================================================
+
+    GainRamp.h
+    Created: 18 Oct 2026 1:41:37pm
+    Author:  zazz
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "NoiseGenerator.h"
+
+//==============================================================================
+// Per sample gain that moves to a new target at a constant rate in dB. The state
+// advances once per block and the same segment is applied to every channel.
+class GainRamp
+{
+public:
+	GainRamp() {};
+
+	// Ramps start and end here instead of at silence, so they stay multiplicative
+	static constexpr float SILENCE_GAIN = 1.0e-5f;
+
+	// First length samples ramp from start, the rest of the block sits at end
+	struct Segment
+	{
+		float start = 0.0f;
+		float multiplier = 1.0f;
+		int length = 0;
+		float end = 0.0f;
+
+		bool isSilent() const
+		{
+			return length == 0 && end == 0.0f;
+		}
+	};
+
+	void prepare(double sampleRate, double rampSeconds)
+	{
+		m_rampLength = (int)(sampleRate * rampSeconds) > 1 ? (int)(sampleRate * rampSeconds) : 1;
+		m_remaining = 0;
+		m_current = m_target;
+	}
+
+	void setTarget(float gain)
+	{
+		if (gain == m_target)
+			return;
+
+		const float from = m_current > SILENCE_GAIN ? m_current : SILENCE_GAIN;
+		const float to = gain > SILENCE_GAIN ? gain : SILENCE_GAIN;
+
+		m_target = gain;
+		m_current = from;
+		m_multiplier = powf(to / from, 1.0f / (float)m_rampLength);
+		m_remaining = m_rampLength;
+	}
+	float getTarget() const
+	{
+		return m_target;
+	}
+	bool isRamping() const
+	{
+		return m_remaining > 0;
+	}
+
+	Segment advance(int numSamples)
+	{
+		Segment segment;
+		segment.start = m_current;
+		segment.multiplier = m_multiplier;
+		segment.length = numSamples < m_remaining ? numSamples : m_remaining;
+
+		m_remaining -= segment.length;
+		m_current = m_remaining > 0 ? m_current * powf(m_multiplier, (float)segment.length) : m_target;
+
+		segment.end = m_target;
+		return segment;
+	}
+
+	static void apply(float* data, int numSamples, const Segment& segment)
+	{
+		NoiseKernels::multiplyRamp(data, segment.length, segment.start, segment.multiplier);
+
+		for (int i = segment.length; i < numSamples; i++)
+		{
+			data[i] *= segment.end;
+		}
+	}
+	// Ramps are short, so the double version is a plain loop
+	static void apply(double* data, int numSamples, const Segment& segment)
+	{
+		double gain = segment.start;
+
+		for (int i = 0; i < segment.length; i++)
+		{
+			data[i] *= gain;
+			gain *= segment.multiplier;
+		}
+		for (int i = segment.length; i < numSamples; i++)
+		{
+			data[i] *= segment.end;
+		}
+	}
+
+private:
+	float m_target = 0.0f;
+	float m_current = 0.0f;
+	float m_multiplier = 1.0f;
+	int m_rampLength = 1;
+	int m_remaining = 0;
+};
@@ -0,0 +1,276 @@
+/*
+  ==============================================================================
+
+    NoiseAnalysis.h
+    Created: 18 Oct 2026 11:02:15am
+    Author:  zazz
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <math.h>
+#include <chrono>
+#include <complex>
+#include <vector>
+
+//==============================================================================
+// Cost and quality measurements for the generators in NoiseGenerator.h
+namespace NoiseAnalysis
+{
+	//==============================================================================
+	// In place radix 2 complex FFT
+	class Fft
+	{
+	public:
+		Fft(int order) : m_size(1 << order), m_twiddles((size_t)m_size)
+		{
+			// Twiddles of the stage with half length h sit contiguously from index h
+			const double pi = 3.14159265358979323846;
+			for (int half = 1; half < m_size; half <<= 1)
+			{
+				for (int k = 0; k < half; k++)
+				{
+					m_twiddles[(size_t)(half + k)] = std::polar(1.0f, (float)(-pi * k / half));
+				}
+			}
+		}
+
+		int getSize() const
+		{
+			return m_size;
+		}
+		void perform(std::complex<float>* data, bool inverse) const
+		{
+			for (int i = 1, j = 0; i < m_size; i++)
+			{
+				int bit = m_size >> 1;
+				for (; j & bit; bit >>= 1)
+				{
+					j ^= bit;
+				}
+				j ^= bit;
+
+				if (i < j)
+					std::swap(data[i], data[j]);
+			}
+
+			// Written out, std::complex multiplication checks for NaN and is several times slower
+			const float sign = inverse ? -1.0f : 1.0f;
+			for (int half = 1; half < m_size; half <<= 1)
+			{
+				const std::complex<float>* twiddles = m_twiddles.data() + half;
+
+				for (int start = 0; start < m_size; start += 2 * half)
+				{
+					std::complex<float>* even = data + start;
+					std::complex<float>* odd = data + start + half;
+
+					for (int k = 0; k < half; k++)
+					{
+						const float twiddleReal = twiddles[k].real();
+						const float twiddleImag = sign * twiddles[k].imag();
+						const float oddReal = odd[k].real() * twiddleReal - odd[k].imag() * twiddleImag;
+						const float oddImag = odd[k].real() * twiddleImag + odd[k].imag() * twiddleReal;
+						const float evenReal = even[k].real();
+						const float evenImag = even[k].imag();
+
+						odd[k] = std::complex<float>(evenReal - oddReal, evenImag - oddImag);
+						even[k] = std::complex<float>(evenReal + oddReal, evenImag + oddImag);
+					}
+				}
+			}
+
+			if (inverse)
+			{
+				const float scale = 1.0f / m_size;
+				for (int i = 0; i < m_size; i++)
+				{
+					data[i] *= scale;
+				}
+			}
+		}
+
+	private:
+		int m_size;
+		std::vector<std::complex<float>> m_twiddles;
+	};
+
+	//==============================================================================
+	// Counts samples into bins spanning [minimum, maximum), out of range samples are dropped
+	inline void histogram(const float* data, int numSamples, float minimum, float maximum, double* counts, int bins)
+	{
+		const float scale = bins / (maximum - minimum);
+
+		for (int i = 0; i < numSamples; i++)
+		{
+			const int bin = (int)floorf((data[i] - minimum) * scale);
+			if (bin >= 0 && bin < bins)
+				counts[bin] += 1.0;
+		}
+	}
+
+	// Expected bin counts for a distribution given by its CDF
+	template <typename Cdf>
+	inline void expectedCounts(Cdf cdf, int numSamples, float minimum, float maximum, double* counts, int bins)
+	{
+		const double width = (maximum - minimum) / (double)bins;
+
+		for (int bin = 0; bin < bins; bin++)
+		{
+			counts[bin] = numSamples * (cdf(minimum + (bin + 1) * width) - cdf(minimum + bin * width));
+		}
+	}
+
+	inline double uniformCdf(double x)
+	{
+		return x < -1.0 ? 0.0 : x > 1.0 ? 1.0 : 0.5 * (x + 1.0);
+	}
+
+	inline double normalCdf(double x, double standardDeviation)
+	{
+		return 0.5 * erfc(-x / (standardDeviation * sqrt(2.0)));
+	}
+
+	// Bins expecting fewer than 5 samples are skipped, as usual for the test
+	inline double chiSquare(const double* observed, const double* expected, int bins, int* degreesOfFreedom = nullptr)
+	{
+		double sum = 0.0;
+		int used = 0;
+
+		for (int bin = 0; bin < bins; bin++)
+		{
+			if (expected[bin] < 5.0)
+				continue;
+
+			const double difference = observed[bin] - expected[bin];
+			sum += difference * difference / expected[bin];
+			used++;
+		}
+
+		if (degreesOfFreedom != nullptr)
+			*degreesOfFreedom = used > 0 ? used - 1 : 0;
+
+		return sum;
+	}
+
+	//==============================================================================
+	// Normalised autocorrelation at lag, 0 for white noise
+	inline double autocorrelation(const float* data, int numSamples, int lag)
+	{
+		double mean = 0.0;
+		for (int i = 0; i < numSamples; i++)
+		{
+			mean += data[i];
+		}
+		mean /= numSamples;
+
+		double variance = 0.0;
+		double covariance = 0.0;
+		for (int i = 0; i < numSamples; i++)
+		{
+			const double centered = data[i] - mean;
+			variance += centered * centered;
+
+			if (i + lag < numSamples)
+				covariance += centered * (data[i + lag] - mean);
+		}
+
+		return variance > 0.0 ? covariance / variance : 0.0;
+	}
+
+	// Hann windowed, averaged periodogram, power has fft.getSize() / 2 + 1 bins
+	inline void powerSpectrum(const Fft& fft, const float* data, int numSamples, double* power)
+	{
+		const double pi = 3.14159265358979323846;
+		const int size = fft.getSize();
+		const int bins = size / 2 + 1;
+
+		std::vector<std::complex<float>> frame((size_t)size);
+
+		for (int bin = 0; bin < bins; bin++)
+		{
+			power[bin] = 0.0;
+		}
+
+		int frames = 0;
+		for (int start = 0; start + size <= numSamples; start += size / 2, frames++)
+		{
+			for (int i = 0; i < size; i++)
+			{
+				const float window = (float)(0.5 - 0.5 * cos(2.0 * pi * i / size));
+				frame[(size_t)i] = std::complex<float>(window * data[start + i], 0.0f);
+			}
+
+			fft.perform(frame.data(), false);
+
+			for (int bin = 0; bin < bins; bin++)
+			{
+				power[bin] += std::norm(frame[(size_t)bin]);
+			}
+		}
+
+		for (int bin = 0; frames > 0 && bin < bins; bin++)
+		{
+			power[bin] /= frames;
+		}
+	}
+
+	// Geometric over arithmetic mean of the spectrum without DC and Nyquist, 1 for perfectly white
+	inline double spectralFlatness(const float* data, int numSamples, int fftOrder)
+	{
+		const Fft fft(fftOrder);
+		const int bins = fft.getSize() / 2 + 1;
+
+		std::vector<double> power((size_t)bins);
+		powerSpectrum(fft, data, numSamples, power.data());
+
+		double logSum = 0.0;
+		double sum = 0.0;
+		for (int bin = 1; bin < bins - 1; bin++)
+		{
+			logSum += log(power[(size_t)bin] + 1e-30);
+			sum += power[(size_t)bin];
+		}
+
+		const int count = bins - 2;
+		return sum > 0.0 ? exp(logSum / count) / (sum / count) : 0.0;
+	}
+
+	// Smallest p where the first window samples repeat at p, 0 if no repeat was found
+	inline int findPeriod(const float* data, int numSamples, int window)
+	{
+		for (int period = 1; period + window <= numSamples; period++)
+		{
+			int i = 0;
+			while (i < window && data[i] == data[period + i])
+			{
+				i++;
+			}
+
+			if (i == window)
+				return period;
+		}
+
+		return 0;
+	}
+
+	//==============================================================================
+	// Cost of generator.processBlock at the given block size
+	template <typename Generator>
+	inline double nanosecondsPerSample(Generator& generator, int blockSize, int totalSamples)
+	{
+		std::vector<float> block((size_t)blockSize);
+		const int blocks = totalSamples / blockSize > 0 ? totalSamples / blockSize : 1;
+
+		const auto start = std::chrono::steady_clock::now();
+		for (int i = 0; i < blocks; i++)
+		{
+			generator.processBlock(block.data(), blockSize, 1.0f);
+		}
+		const auto end = std::chrono::steady_clock::now();
+
+		return std::chrono::duration<double, std::nano>(end - start).count() / ((double)blocks * blockSize);
+	}
+}
@@ -0,0 +1,165 @@
+/*
+  ==============================================================================
+
+    NoiseBank.cpp
+    Created: 18 Oct 2026 10:12:40am
+    Author:  zazz
+
+  ==============================================================================
+*/
+
+#include "NoiseBank.h"
+
+//==============================================================================
+NoiseBank::NoiseBank() : juce::Thread("Noise Bank")
+{
+}
+
+NoiseBank::~NoiseBank()
+{
+	release();
+}
+
+void NoiseBank::prepare(int channels, int capacity, uint32_t seed, uint32_t firstStream)
+{
+	release();
+
+	// Whole chunks never wrap around the end of the ring
+	m_capacity = ((capacity + CHUNK - 1) / CHUNK + 1) * CHUNK;
+	m_channels = channels;
+
+	if (seed != m_seed || firstStream != m_firstStream)
+	{
+		m_generators.clear();
+		m_seed = seed;
+		m_firstStream = firstStream;
+	}
+}
+
+void NoiseBank::release()
+{
+	stopThread(1000);
+	m_allocated.store(false, std::memory_order_relaxed);
+	m_channels = 0;
+}
+
+void NoiseBank::start()
+{
+	if (m_channels == 0 || isThreadRunning())
+		return;
+
+	// The audio thread does not touch the ring until it is published
+	if (!m_allocated.load(std::memory_order_relaxed))
+	{
+		m_fifo.setTotalSize(m_capacity);
+		m_fifo.reset();
+		m_buffer.setSize(m_channels, m_capacity);
+		m_chunkTypes.assign((size_t)(m_capacity / CHUNK), -1);
+
+		const int seeded = (int)m_generators.size();
+		if (m_channels > seeded)
+		{
+			m_generators.resize((size_t)m_channels);
+			WhiteNoiseGenerator::setStreams(m_generators.data() + seeded, m_channels - seeded, m_seed, m_firstStream + (uint32_t)seeded);
+		}
+
+		m_allocated.store(true, std::memory_order_release);
+	}
+
+	startThread(juce::Thread::Priority::low);
+}
+
+void NoiseBank::stop()
+{
+	// What is in the ring stays readable
+	if (isThreadRunning())
+		stopThread(1000);
+}
+
+int NoiseBank::read(float* const* channelData, int channels, int numSamples, float gain)
+{
+	if (!m_allocated.load(std::memory_order_acquire))
+		return 0;
+
+	const int distributionType = m_distributionType.load(std::memory_order_relaxed);
+	channels = juce::jmin(channels, m_channels);
+
+	int done = 0;
+	while (done < numSamples && channels > 0)
+	{
+		const int ready = m_fifo.getNumReady();
+		if (ready == 0)
+			break;
+
+		int start1, size1, start2, size2;
+		m_fifo.prepareToRead(juce::jmin(ready, numSamples - done), start1, size1, start2, size2);
+
+		const int starts[2] = { start1, start2 };
+		const int sizes[2] = { size1, size2 };
+
+		for (int block = 0; block < 2; block++)
+		{
+			int position = starts[block];
+			int remaining = sizes[block];
+
+			while (remaining > 0)
+			{
+				// Chunks left over from a previous distribution are skipped
+				const int length = juce::jmin(remaining, CHUNK - position % CHUNK);
+				if (m_chunkTypes[(size_t)(position / CHUNK)] == distributionType)
+				{
+					for (int channel = 0; channel < channels; channel++)
+					{
+						juce::FloatVectorOperations::copyWithMultiply(channelData[channel] + done, m_buffer.getReadPointer(channel, position), gain, length);
+					}
+					done += length;
+				}
+
+				position += length;
+				remaining -= length;
+			}
+		}
+
+		m_fifo.finishedRead(size1 + size2);
+	}
+
+	if (done < numSamples)
+		m_underruns.fetch_add(1, std::memory_order_relaxed);
+
+	return done;
+}
+
+void NoiseBank::run()
+{
+	while (!threadShouldExit())
+	{
+		if (m_enabled.load(std::memory_order_relaxed))
+			fill();
+
+		wait(FILL_INTERVAL_MS);
+	}
+}
+
+void NoiseBank::fill()
+{
+	const int distributionType = m_distributionType.load(std::memory_order_relaxed);
+
+	for (auto& generator : m_generators)
+	{
+		generator.setDistributionType((WhiteNoiseGenerator::DistributionType)distributionType);
+	}
+
+	while (m_fifo.getFreeSpace() >= CHUNK && !threadShouldExit())
+	{
+		int start1, size1, start2, size2;
+		m_fifo.prepareToWrite(CHUNK, start1, size1, start2, size2);
+
+		for (int channel = 0; channel < m_channels; channel++)
+		{
+			m_generators[(size_t)channel].processBlock(m_buffer.getWritePointer(channel, start1), size1, 1.0f);
+		}
+
+		m_chunkTypes[(size_t)(start1 / CHUNK)] = distributionType;
+		m_fifo.finishedWrite(size1);
+	}
+}
@@ -0,0 +1,87 @@
+/*
+  ==============================================================================
+
+    NoiseBank.h
+    Created: 18 Oct 2026 10:12:40am
+    Author:  zazz
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "NoiseGenerator.h"
+
+//==============================================================================
+// Pre-generates noise on a low priority thread into a lock free single producer,
+// single consumer ring, so the audio thread only has to copy it
+class NoiseBank : private juce::Thread
+{
+public:
+	NoiseBank();
+	~NoiseBank() override;
+
+	// Not thread safe, call while the audio thread is stopped. Only records the
+	// layout, nothing is allocated or started until start.
+	void prepare(int channels, int capacity, uint32_t seed, uint32_t firstStream);
+	void release();
+
+	// Message thread, the audio thread may be running. The first start after
+	// prepare allocates the ring and seeds any generators not seeded yet,
+	// generators are kept across prepare calls unless their streams move.
+	void start();
+	void stop();
+
+	bool isRunning() const
+	{
+		return isThreadRunning();
+	}
+
+	void setEnabled(bool enabled)
+	{
+		m_enabled.store(enabled, std::memory_order_relaxed);
+	}
+	void setDistributionType(WhiteNoiseGenerator::DistributionType distributionType)
+	{
+		m_distributionType.store((int)distributionType, std::memory_order_relaxed);
+	}
+
+	// Audio thread, copies up to numSamples scaled by gain and returns how many
+	// were available. Anything less than numSamples counts as an underrun, once
+	// the bank has been started.
+	int read(float* const* channelData, int channels, int numSamples, float gain);
+
+	uint32_t getUnderrunCount() const
+	{
+		return m_underruns.load(std::memory_order_relaxed);
+	}
+
+private:
+	void run() override;
+	void fill();
+
+	static const int CHUNK = 256;
+	static const int FILL_INTERVAL_MS = 20;
+
+	juce::AbstractFifo m_fifo{ CHUNK };
+	juce::AudioBuffer<float> m_buffer;
+
+	// Distribution each chunk in the ring was generated with
+	std::vector<int> m_chunkTypes;
+
+	std::vector<WhiteNoiseGenerator> m_generators;
+	uint32_t m_seed = 0;
+	uint32_t m_firstStream = 0;
+	int m_channels = 0;
+	int m_capacity = 0;
+
+	// Set once the ring is allocated for the current layout
+	std::atomic<bool> m_allocated{ false };
+
+	std::atomic<int> m_distributionType{ (int)WhiteNoiseGenerator::DistributionType::Uniform };
+	std::atomic<bool> m_enabled{ false };
+	std::atomic<uint32_t> m_underruns{ 0 };
+
+	JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (NoiseBank)
+};
@@ -0,0 +1,126 @@
+/*
+  ==============================================================================
+
+    NoiseDither.cpp
+    Created: 18 Oct 2026 9:02:37pm
+    Author:  zazz
+
+  ==============================================================================
+*/
+
+#include "NoiseDither.h"
+
+// Adding and subtracting 1.5 * 2^52 rounds a double to the nearest integer
+static const double ROUND_MAGIC = 6755399441055744.0;
+
+// Only clipping makes the error larger than the dither plus half a step, the
+// clamp keeps the feedback from running away after it
+static const double MAX_ERROR = 2.0;
+
+// Error feedback filters, the noise transfer function is 1 - sum c[k] z^-(k + 1).
+// High pass is a first order difference, shaped is the 9 tap F-weighted filter
+// by Wannamaker, designed for 44.1 kHz and close enough at 48 kHz.
+static const double HIGH_PASS_COEFFICIENTS[] = { 1.0 };
+static const double SHAPED_COEFFICIENTS[] = { 2.412, -3.370, 3.937, -4.174, 3.353, -2.205, 1.281, -0.569, 0.0847 };
+
+//==============================================================================
+void NoiseDither::reset()
+{
+	std::fill(m_errors, m_errors + MAX_ORDER, 0.0);
+}
+
+template <typename SampleType>
+void NoiseDither::process(WhiteNoiseGenerator& generator, SampleType* data, int numSamples, Type type, Depth depth)
+{
+	if (type == Type::Off)
+		return;
+
+	const double scale = (double)(1 << (getBits(depth) - 1));
+
+	while (numSamples > 0)
+	{
+		const int count = numSamples < BLOCK_SIZE ? numSamples : BLOCK_SIZE;
+
+		// Half a step either way
+		generator.processBlock<WhiteNoiseGenerator::DistributionType::Uniform>(m_uniform + 1, count, 0.5f);
+
+		const float* noise = m_uniform + 1;
+		if (type != Type::Rectangular)
+		{
+			for (int i = 0; i < count; i++)
+			{
+				m_triangular[i] = m_uniform[i + 1] - m_uniform[i];
+			}
+			noise = m_triangular;
+		}
+		m_uniform[0] = m_uniform[count];
+
+		switch (type)
+		{
+		case Type::HighPass:	quantiseShaped<1>(data, noise, count, scale, HIGH_PASS_COEFFICIENTS); break;
+		case Type::Shaped:		quantiseShaped<MAX_ORDER>(data, noise, count, scale, SHAPED_COEFFICIENTS); break;
+		default:				quantise(data, noise, count, scale); break;
+		}
+
+		data += count;
+		numSamples -= count;
+	}
+}
+
+template void NoiseDither::process<float>(WhiteNoiseGenerator& generator, float* data, int numSamples, Type type, Depth depth);
+template void NoiseDither::process<double>(WhiteNoiseGenerator& generator, double* data, int numSamples, Type type, Depth depth);
+
+//==============================================================================
+// No state, so the compiler vectorises it
+template <typename SampleType>
+void NoiseDither::quantise(SampleType* data, const float* noise, int numSamples, double scale)
+{
+	const double inverse = 1.0 / scale;
+	const double top = scale - 1.0;
+
+	for (int i = 0; i < numSamples; i++)
+	{
+		double value = (double)data[i] * scale + (double)noise[i];
+		value = (value + ROUND_MAGIC) - ROUND_MAGIC;
+		value = value < -scale ? -scale : value > top ? top : value;
+		data[i] = (SampleType)(value * inverse);
+	}
+}
+
+// Order is fixed at compile time, so the filter and the history shift unroll
+template <int order, typename SampleType>
+void NoiseDither::quantiseShaped(SampleType* data, const float* noise, int numSamples, double scale, const double* coefficients)
+{
+	const double inverse = 1.0 / scale;
+	const double top = scale - 1.0;
+
+	// Local copy, so the history stays in registers
+	double errors[MAX_ORDER];
+	std::copy(m_errors, m_errors + MAX_ORDER, errors);
+
+	for (int i = 0; i < numSamples; i++)
+	{
+		double feedback = 0.0;
+		for (int k = 0; k < order; k++)
+		{
+			feedback += coefficients[k] * errors[k];
+		}
+
+		const double target = (double)data[i] * scale - feedback;
+
+		double value = target + (double)noise[i];
+		value = (value + ROUND_MAGIC) - ROUND_MAGIC;
+		value = value < -scale ? -scale : value > top ? top : value;
+
+		const double error = value - target;
+		for (int k = order - 1; k > 0; k--)
+		{
+			errors[k] = errors[k - 1];
+		}
+		errors[0] = error < -MAX_ERROR ? -MAX_ERROR : error > MAX_ERROR ? MAX_ERROR : error;
+
+		data[i] = (SampleType)(value * inverse);
+	}
+
+	std::copy(errors, errors + MAX_ORDER, m_errors);
+}
@@ -0,0 +1,77 @@
+/*
+  ==============================================================================
+
+    NoiseDither.h
+    Created: 18 Oct 2026 9:02:37pm
+    Author:  zazz
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "NoiseGenerator.h"
+
+//==============================================================================
+// Word length reduction of one channel, dithered with the channel's uniform
+// noise stream. Triangular dither is the difference of consecutive uniform
+// values, so it needs one new value per sample and its spectrum rises by 6 dB
+// per octave. The shaped types feed the total error back through a FIR filter,
+// dither included.
+class NoiseDither
+{
+public:
+	NoiseDither() {};
+
+	enum Type
+	{
+		Off,
+		Rectangular,
+		Triangular,
+		HighPass,
+		Shaped
+	};
+
+	// Target word lengths
+	enum Depth
+	{
+		Bits16,
+		Bits20,
+		Bits24
+	};
+
+	static const int MAX_ORDER = 9;
+
+	// Dither is generated this many samples at a time
+	static const int BLOCK_SIZE = 64;
+
+	static int getBits(Depth depth)
+	{
+		switch (depth)
+		{
+		case Depth::Bits16:	return 16;
+		case Depth::Bits20:	return 20;
+		default:			return 24;
+		}
+	}
+
+	// Clears the error history, the noise stream carries on
+	void reset();
+
+	// In place, the generator has to be free for the dither while this runs
+	template <typename SampleType>
+	void process(WhiteNoiseGenerator& generator, SampleType* data, int numSamples, Type type, Depth depth);
+
+private:
+	template <typename SampleType>
+	static void quantise(SampleType* data, const float* noise, int numSamples, double scale);
+	template <int order, typename SampleType>
+	void quantiseShaped(SampleType* data, const float* noise, int numSamples, double scale, const double* coefficients);
+
+	// Uniform values in half steps, the first one is the last of the previous block
+	float m_uniform[BLOCK_SIZE + 1] = {};
+	float m_triangular[BLOCK_SIZE] = {};
+
+	// Newest error first, in steps of the target word length
+	double m_errors[MAX_ORDER] = {};
+};
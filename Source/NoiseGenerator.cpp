@@ -9,3 +9,1523 @@
 */
 
 #include "NoiseGenerator.h"
+
+#include <atomic>
+#include <mutex>
+#include <string.h>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+	#define NOISE_KERNELS_X86 1
+	#include <immintrin.h>
+	#if defined(_MSC_VER)
+		#include <intrin.h>
+		#define NOISE_TARGET_SSE2
+		#define NOISE_TARGET_AVX2
+	#else
+		#define NOISE_TARGET_SSE2 __attribute__((target("sse2")))
+		#define NOISE_TARGET_AVX2 __attribute__((target("avx2")))
+	#endif
+#else
+	#define NOISE_KERNELS_X86 0
+#endif
+
+namespace NoiseKernels
+{
+	//==============================================================================
+	// Shared constants
+	static const uint32_t MT_M = 397;
+	static const uint32_t MT_MATRIX_A = 0x9908b0dfu;
+	static const uint32_t MT_UPPER_MASK = 0x80000000u;
+	static const uint32_t MT_LOWER_MASK = 0x7fffffffu;
+
+	static inline uint32_t power(uint32_t base, int exponent)
+	{
+		uint32_t result = 1u;
+		for (int i = 0; i < exponent; i++)
+		{
+			result *= base;
+		}
+		return result;
+	}
+
+	// Lane j of a block starts at state j + 1 of the sequence
+	static inline void seedLanes(uint32_t* lanes, uint32_t state, uint32_t multiplier, uint32_t increment)
+	{
+		for (int j = 0; j < LANES; j++)
+		{
+			state = multiplier * state + increment;
+			lanes[j] = state;
+		}
+	}
+
+	static inline void mersenneStep(uint32_t* mt, int i, int next, int far)
+	{
+		const uint32_t y = (mt[i] & MT_UPPER_MASK) | (mt[next] & MT_LOWER_MASK);
+		mt[i] = mt[far] ^ (y >> 1) ^ ((0u - (y & 1u)) & MT_MATRIX_A);
+	}
+
+	//==============================================================================
+	// Scalar
+	static void fastNoiseScalar(uint32_t* x1, uint32_t* x2, float* out, int numSamples, float gain)
+	{
+		const float scale = gain / 2147483647.0f;
+
+		int i = 0;
+		for (; i + LANES <= numSamples; i += LANES)
+		{
+			for (int j = 0; j < LANES; j++)
+			{
+				x1[j] ^= x2[j];
+				out[i + j] = scale * (float)(int32_t)x2[j];
+				x2[j] += x1[j];
+			}
+		}
+
+		for (int j = 0; i < numSamples; i++, j++)
+		{
+			x1[j] ^= x2[j];
+			out[i] = scale * (float)(int32_t)x2[j];
+			x2[j] += x1[j];
+		}
+	}
+
+	static uint32_t lehmerScalar(uint32_t state, uint32_t multiplier, uint32_t modulus, float* out, int numSamples, float gain)
+	{
+		const uint32_t mask = modulus - 1u;
+		const float scale = gain * 2.0f / (float)modulus;
+
+		for (int i = 0; i < numSamples; i++)
+		{
+			state = (multiplier * state) & mask;
+			out[i] = scale * (float)state - gain;
+		}
+
+		return state;
+	}
+
+	static uint32_t linearCongruentialScalar(uint32_t state, uint32_t multiplier, uint32_t increment, float* out, int numSamples, float gain)
+	{
+		const float scale = gain * 2.0f / 32767.0f;
+
+		for (int i = 0; i < numSamples; i++)
+		{
+			state = multiplier * state + increment;
+			out[i] = scale * (float)((state >> 16) & 0x7fffu) - gain;
+		}
+
+		return state;
+	}
+
+	static void mersenneTwistScalar(uint32_t* mt)
+	{
+		int i = 0;
+		for (; i < MersenneTwister::N - (int)MT_M; i++)
+		{
+			mersenneStep(mt, i, i + 1, i + MT_M);
+		}
+		for (; i < MersenneTwister::N - 1; i++)
+		{
+			mersenneStep(mt, i, i + 1, i + MT_M - MersenneTwister::N);
+		}
+		mersenneStep(mt, MersenneTwister::N - 1, 0, MT_M - 1);
+	}
+
+	static void mersenneUniformScalar(const uint32_t* state, float* out, int numSamples, float gain)
+	{
+		for (int i = 0; i < numSamples; i++)
+		{
+			out[i] = gain * bitsToFloat(temper(state[i]));
+		}
+	}
+
+	static void mersenneSignScalar(const uint32_t* state, float* out, int numSamples, float gain)
+	{
+		for (int i = 0; i < numSamples; i++)
+		{
+			out[i] = (temper(state[i]) & 0x80000000u) ? gain : -gain;
+		}
+	}
+
+	static void mersenneTemperScalar(const uint32_t* state, uint32_t* out, int numSamples)
+	{
+		for (int i = 0; i < numSamples; i++)
+		{
+			out[i] = temper(state[i]);
+		}
+	}
+
+	// Philox4x32-10
+	static const uint32_t PHILOX_M0 = 0xd2511f53u;
+	static const uint32_t PHILOX_M1 = 0xcd9e8d57u;
+	static const uint32_t PHILOX_W0 = 0x9e3779b9u;
+	static const uint32_t PHILOX_W1 = 0xbb67ae85u;
+	static const int PHILOX_ROUNDS = 10;
+
+	static void philoxScalar(const uint32_t* key, uint64_t firstBlock, uint32_t* out, int numBlocks)
+	{
+		for (int b = 0; b < numBlocks; b++)
+		{
+			const uint64_t block = firstBlock + (uint64_t)b;
+			const uint32_t counter[4] = { (uint32_t)block, (uint32_t)(block >> 32), 0u, 0u };
+			philoxBlock(key, counter, out + 4 * b);
+		}
+	}
+
+	static void aliasSampleScalar(const AliasEntry* entries, uint32_t numBins, const uint32_t* bits, float* out, int numSamples, float gain)
+	{
+		for (int i = 0; i < numSamples; i++)
+		{
+			out[i] = gain * aliasSample(entries, numBins, bits[i]);
+		}
+	}
+
+	// Multiplier^j for j < LANES, returns multiplier^LANES
+	static inline float rampPowers(float multiplier, float* powers)
+	{
+		float step = 1.0f;
+		for (int j = 0; j < LANES; j++)
+		{
+			powers[j] = step;
+			step *= multiplier;
+		}
+		return step;
+	}
+
+	static void multiplyRampScalar(float* data, int numSamples, float start, float multiplier)
+	{
+		float powers[LANES];
+		const float step = rampPowers(multiplier, powers);
+		float base = start;
+
+		int i = 0;
+		for (; i + LANES <= numSamples; i += LANES)
+		{
+			for (int j = 0; j < LANES; j++)
+			{
+				data[i + j] *= base * powers[j];
+			}
+			base *= step;
+		}
+
+		for (int j = 0; i < numSamples; i++, j++)
+		{
+			data[i] *= base * powers[j];
+		}
+	}
+
+	static void interpolateScalar(const float* input, int numInputs, int factor, const float* phases, int taps, float* out)
+	{
+		for (int m = 0; m < numInputs; m++)
+		{
+			for (int p = 0; p < factor; p++)
+			{
+				const float* coefficients = phases + p * taps;
+				float sum = 0.0f;
+
+				for (int k = 0; k < taps; k++)
+				{
+					sum += coefficients[k] * input[m - k];
+				}
+
+				out[m * factor + p] = sum;
+			}
+		}
+	}
+
+#if NOISE_KERNELS_X86
+	//==============================================================================
+	// SSE2
+	NOISE_TARGET_SSE2 static inline __m128i mullo32(__m128i a, __m128i b)
+	{
+		const __m128i even = _mm_mul_epu32(a, b);
+		const __m128i odd = _mm_mul_epu32(_mm_srli_epi64(a, 32), _mm_srli_epi64(b, 32));
+		return _mm_unpacklo_epi32(_mm_shuffle_epi32(even, _MM_SHUFFLE(0, 0, 2, 0)), _mm_shuffle_epi32(odd, _MM_SHUFFLE(0, 0, 2, 0)));
+	}
+
+	NOISE_TARGET_SSE2 static inline __m128i temperSSE2(__m128i y)
+	{
+		y = _mm_xor_si128(y, _mm_srli_epi32(y, 11));
+		y = _mm_xor_si128(y, _mm_and_si128(_mm_slli_epi32(y, 7), _mm_set1_epi32((int)0x9d2c5680u)));
+		y = _mm_xor_si128(y, _mm_and_si128(_mm_slli_epi32(y, 15), _mm_set1_epi32((int)0xefc60000u)));
+		return _mm_xor_si128(y, _mm_srli_epi32(y, 18));
+	}
+
+	NOISE_TARGET_SSE2 static inline __m128i mersenneStepSSE2(__m128i current, __m128i next, __m128i far)
+	{
+		const __m128i y = _mm_or_si128(_mm_and_si128(current, _mm_set1_epi32((int)MT_UPPER_MASK)), _mm_and_si128(next, _mm_set1_epi32((int)MT_LOWER_MASK)));
+		const __m128i mag = _mm_and_si128(_mm_sub_epi32(_mm_setzero_si128(), _mm_and_si128(y, _mm_set1_epi32(1))), _mm_set1_epi32((int)MT_MATRIX_A));
+		return _mm_xor_si128(_mm_xor_si128(far, _mm_srli_epi32(y, 1)), mag);
+	}
+
+	NOISE_TARGET_SSE2 static void fastNoiseSSE2(uint32_t* x1, uint32_t* x2, float* out, int numSamples, float gain)
+	{
+		const __m128 scale = _mm_set1_ps(gain / 2147483647.0f);
+
+		__m128i a0 = _mm_loadu_si128((const __m128i*)x1);
+		__m128i a1 = _mm_loadu_si128((const __m128i*)(x1 + 4));
+		__m128i b0 = _mm_loadu_si128((const __m128i*)x2);
+		__m128i b1 = _mm_loadu_si128((const __m128i*)(x2 + 4));
+
+		int i = 0;
+		for (; i + LANES <= numSamples; i += LANES)
+		{
+			a0 = _mm_xor_si128(a0, b0);
+			a1 = _mm_xor_si128(a1, b1);
+			_mm_storeu_ps(out + i, _mm_mul_ps(scale, _mm_cvtepi32_ps(b0)));
+			_mm_storeu_ps(out + i + 4, _mm_mul_ps(scale, _mm_cvtepi32_ps(b1)));
+			b0 = _mm_add_epi32(b0, a0);
+			b1 = _mm_add_epi32(b1, a1);
+		}
+
+		_mm_storeu_si128((__m128i*)x1, a0);
+		_mm_storeu_si128((__m128i*)(x1 + 4), a1);
+		_mm_storeu_si128((__m128i*)x2, b0);
+		_mm_storeu_si128((__m128i*)(x2 + 4), b1);
+
+		fastNoiseScalar(x1, x2, out + i, numSamples - i, gain);
+	}
+
+	NOISE_TARGET_SSE2 static uint32_t lehmerSSE2(uint32_t state, uint32_t multiplier, uint32_t modulus, float* out, int numSamples, float gain)
+	{
+		if (numSamples < LANES)
+			return lehmerScalar(state, multiplier, modulus, out, numSamples, gain);
+
+		alignas(16) uint32_t lanes[LANES];
+		seedLanes(lanes, state, multiplier, 0u);
+
+		const __m128i mask = _mm_set1_epi32((int)(modulus - 1u));
+		const __m128i step = _mm_set1_epi32((int)power(multiplier, LANES));
+		const __m128 scale = _mm_set1_ps(gain * 2.0f / (float)modulus);
+		const __m128 offset = _mm_set1_ps(gain);
+
+		__m128i l0 = _mm_and_si128(_mm_load_si128((const __m128i*)lanes), mask);
+		__m128i l1 = _mm_and_si128(_mm_load_si128((const __m128i*)(lanes + 4)), mask);
+
+		int i = 0;
+		for (;;)
+		{
+			_mm_storeu_ps(out + i, _mm_sub_ps(_mm_mul_ps(scale, _mm_cvtepi32_ps(l0)), offset));
+			_mm_storeu_ps(out + i + 4, _mm_sub_ps(_mm_mul_ps(scale, _mm_cvtepi32_ps(l1)), offset));
+			i += LANES;
+
+			if (i + LANES > numSamples)
+				break;
+
+			l0 = _mm_and_si128(mullo32(l0, step), mask);
+			l1 = _mm_and_si128(mullo32(l1, step), mask);
+		}
+
+		_mm_store_si128((__m128i*)(lanes + 4), l1);
+		return lehmerScalar(lanes[LANES - 1], multiplier, modulus, out + i, numSamples - i, gain);
+	}
+
+	NOISE_TARGET_SSE2 static uint32_t linearCongruentialSSE2(uint32_t state, uint32_t multiplier, uint32_t increment, float* out, int numSamples, float gain)
+	{
+		if (numSamples < LANES)
+			return linearCongruentialScalar(state, multiplier, increment, out, numSamples, gain);
+
+		alignas(16) uint32_t lanes[LANES];
+		seedLanes(lanes, state, multiplier, increment);
+
+		// x[n + 8] = A * x[n] + C
+		uint32_t stepIncrement = 0u;
+		for (int j = 0; j < LANES; j++)
+		{
+			stepIncrement = multiplier * stepIncrement + increment;
+		}
+
+		const __m128i stepMultiplier = _mm_set1_epi32((int)power(multiplier, LANES));
+		const __m128i stepAdd = _mm_set1_epi32((int)stepIncrement);
+		const __m128i mask = _mm_set1_epi32(0x7fff);
+		const __m128 scale = _mm_set1_ps(gain * 2.0f / 32767.0f);
+		const __m128 offset = _mm_set1_ps(gain);
+
+		__m128i l0 = _mm_load_si128((const __m128i*)lanes);
+		__m128i l1 = _mm_load_si128((const __m128i*)(lanes + 4));
+
+		int i = 0;
+		for (;;)
+		{
+			_mm_storeu_ps(out + i, _mm_sub_ps(_mm_mul_ps(scale, _mm_cvtepi32_ps(_mm_and_si128(_mm_srli_epi32(l0, 16), mask))), offset));
+			_mm_storeu_ps(out + i + 4, _mm_sub_ps(_mm_mul_ps(scale, _mm_cvtepi32_ps(_mm_and_si128(_mm_srli_epi32(l1, 16), mask))), offset));
+			i += LANES;
+
+			if (i + LANES > numSamples)
+				break;
+
+			l0 = _mm_add_epi32(mullo32(l0, stepMultiplier), stepAdd);
+			l1 = _mm_add_epi32(mullo32(l1, stepMultiplier), stepAdd);
+		}
+
+		_mm_store_si128((__m128i*)(lanes + 4), l1);
+		return linearCongruentialScalar(lanes[LANES - 1], multiplier, increment, out + i, numSamples - i, gain);
+	}
+
+	NOISE_TARGET_SSE2 static void mersenneTwistSSE2(uint32_t* mt)
+	{
+		const int N = MersenneTwister::N;
+
+		int i = 0;
+		for (; i + 4 <= N - (int)MT_M; i += 4)
+		{
+			const __m128i current = _mm_loadu_si128((const __m128i*)(mt + i));
+			const __m128i next = _mm_loadu_si128((const __m128i*)(mt + i + 1));
+			const __m128i far = _mm_loadu_si128((const __m128i*)(mt + i + MT_M));
+			_mm_storeu_si128((__m128i*)(mt + i), mersenneStepSSE2(current, next, far));
+		}
+		for (; i < N - (int)MT_M; i++)
+		{
+			mersenneStep(mt, i, i + 1, i + MT_M);
+		}
+
+		// From here the far word has already been twisted, 227 words back
+		for (; i + 4 <= N - 1; i += 4)
+		{
+			const __m128i current = _mm_loadu_si128((const __m128i*)(mt + i));
+			const __m128i next = _mm_loadu_si128((const __m128i*)(mt + i + 1));
+			const __m128i far = _mm_loadu_si128((const __m128i*)(mt + i + MT_M - N));
+			_mm_storeu_si128((__m128i*)(mt + i), mersenneStepSSE2(current, next, far));
+		}
+		for (; i < N - 1; i++)
+		{
+			mersenneStep(mt, i, i + 1, i + MT_M - N);
+		}
+
+		mersenneStep(mt, N - 1, 0, MT_M - 1);
+	}
+
+	NOISE_TARGET_SSE2 static void mersenneUniformSSE2(const uint32_t* state, float* out, int numSamples, float gain)
+	{
+		const __m128i exponent = _mm_set1_epi32(0x3f800000);
+		const __m128 scale = _mm_set1_ps(2.0f * gain);
+		const __m128 offset = _mm_set1_ps(3.0f * gain);
+
+		int i = 0;
+		for (; i + 4 <= numSamples; i += 4)
+		{
+			const __m128i y = temperSSE2(_mm_loadu_si128((const __m128i*)(state + i)));
+			const __m128 f = _mm_castsi128_ps(_mm_or_si128(_mm_srli_epi32(y, 9), exponent));
+			_mm_storeu_ps(out + i, _mm_sub_ps(_mm_mul_ps(f, scale), offset));
+		}
+
+		mersenneUniformScalar(state + i, out + i, numSamples - i, gain);
+	}
+
+	NOISE_TARGET_SSE2 static void mersenneSignSSE2(const uint32_t* state, float* out, int numSamples, float gain)
+	{
+		// +gain when the top bit is set, -gain otherwise
+		const __m128i negativeGain = _mm_castps_si128(_mm_set1_ps(-gain));
+		const __m128i signBit = _mm_set1_epi32((int)0x80000000u);
+
+		int i = 0;
+		for (; i + 4 <= numSamples; i += 4)
+		{
+			const __m128i y = temperSSE2(_mm_loadu_si128((const __m128i*)(state + i)));
+			_mm_storeu_ps(out + i, _mm_castsi128_ps(_mm_xor_si128(negativeGain, _mm_and_si128(y, signBit))));
+		}
+
+		mersenneSignScalar(state + i, out + i, numSamples - i, gain);
+	}
+
+	NOISE_TARGET_SSE2 static void mersenneTemperSSE2(const uint32_t* state, uint32_t* out, int numSamples)
+	{
+		int i = 0;
+		for (; i + 4 <= numSamples; i += 4)
+		{
+			_mm_storeu_si128((__m128i*)(out + i), temperSSE2(_mm_loadu_si128((const __m128i*)(state + i))));
+		}
+
+		mersenneTemperScalar(state + i, out + i, numSamples - i);
+	}
+
+	// High and low halves of a * multiplier in every lane
+	NOISE_TARGET_SSE2 static inline void mulhilo32SSE2(__m128i a, __m128i multiplier, __m128i& high, __m128i& low)
+	{
+		const __m128i even = _mm_shuffle_epi32(_mm_mul_epu32(a, multiplier), _MM_SHUFFLE(3, 1, 2, 0));
+		const __m128i odd = _mm_shuffle_epi32(_mm_mul_epu32(_mm_srli_epi64(a, 32), multiplier), _MM_SHUFFLE(3, 1, 2, 0));
+		low = _mm_unpacklo_epi32(even, odd);
+		high = _mm_unpackhi_epi32(even, odd);
+	}
+
+	// Four blocks per step, each register holds one counter word of every block
+	NOISE_TARGET_SSE2 static void philoxSSE2(const uint32_t* key, uint64_t firstBlock, uint32_t* out, int numBlocks)
+	{
+		const __m128i m0 = _mm_set1_epi32((int)PHILOX_M0);
+		const __m128i m1 = _mm_set1_epi32((int)PHILOX_M1);
+
+		int b = 0;
+		for (; b + 4 <= numBlocks; b += 4)
+		{
+			uint32_t low[4];
+			uint32_t high[4];
+			for (int j = 0; j < 4; j++)
+			{
+				const uint64_t block = firstBlock + (uint64_t)(b + j);
+				low[j] = (uint32_t)block;
+				high[j] = (uint32_t)(block >> 32);
+			}
+
+			__m128i c0 = _mm_loadu_si128((const __m128i*)low);
+			__m128i c1 = _mm_loadu_si128((const __m128i*)high);
+			__m128i c2 = _mm_setzero_si128();
+			__m128i c3 = _mm_setzero_si128();
+			uint32_t k0 = key[0];
+			uint32_t k1 = key[1];
+
+			for (int round = 0; round < PHILOX_ROUNDS; round++)
+			{
+				__m128i high0, low0, high1, low1;
+				mulhilo32SSE2(c0, m0, high0, low0);
+				mulhilo32SSE2(c2, m1, high1, low1);
+
+				c0 = _mm_xor_si128(_mm_xor_si128(high1, c1), _mm_set1_epi32((int)k0));
+				c1 = low1;
+				c2 = _mm_xor_si128(_mm_xor_si128(high0, c3), _mm_set1_epi32((int)k1));
+				c3 = low0;
+
+				k0 += PHILOX_W0;
+				k1 += PHILOX_W1;
+			}
+
+			// Back to four words per block
+			const __m128i t0 = _mm_unpacklo_epi32(c0, c1);
+			const __m128i t1 = _mm_unpacklo_epi32(c2, c3);
+			const __m128i t2 = _mm_unpackhi_epi32(c0, c1);
+			const __m128i t3 = _mm_unpackhi_epi32(c2, c3);
+
+			_mm_storeu_si128((__m128i*)(out + 4 * b), _mm_unpacklo_epi64(t0, t1));
+			_mm_storeu_si128((__m128i*)(out + 4 * b + 4), _mm_unpackhi_epi64(t0, t1));
+			_mm_storeu_si128((__m128i*)(out + 4 * b + 8), _mm_unpacklo_epi64(t2, t3));
+			_mm_storeu_si128((__m128i*)(out + 4 * b + 12), _mm_unpackhi_epi64(t2, t3));
+		}
+
+		philoxScalar(key, firstBlock + (uint64_t)b, out + 4 * b, numBlocks - b);
+	}
+
+	NOISE_TARGET_SSE2 static void multiplyRampSSE2(float* data, int numSamples, float start, float multiplier)
+	{
+		float powers[LANES];
+		const float step = rampPowers(multiplier, powers);
+		const __m128 powersLow = _mm_loadu_ps(powers);
+		const __m128 powersHigh = _mm_loadu_ps(powers + 4);
+		float base = start;
+
+		int i = 0;
+		for (; i + LANES <= numSamples; i += LANES)
+		{
+			const __m128 baseVector = _mm_set1_ps(base);
+			_mm_storeu_ps(data + i, _mm_mul_ps(_mm_loadu_ps(data + i), _mm_mul_ps(baseVector, powersLow)));
+			_mm_storeu_ps(data + i + 4, _mm_mul_ps(_mm_loadu_ps(data + i + 4), _mm_mul_ps(baseVector, powersHigh)));
+			base *= step;
+		}
+
+		for (int j = 0; i < numSamples; i++, j++)
+		{
+			data[i] *= base * powers[j];
+		}
+	}
+
+	// Vectorised over consecutive inputs of one phase, every output sums its taps
+	// in the same order as the scalar kernel
+	NOISE_TARGET_SSE2 static void interpolateSSE2(const float* input, int numInputs, int factor, const float* phases, int taps, float* out)
+	{
+		int m = 0;
+		for (; m + 8 <= numInputs; m += 8)
+		{
+			for (int p = 0; p < factor; p++)
+			{
+				const float* coefficients = phases + p * taps;
+				__m128 low = _mm_setzero_ps();
+				__m128 high = _mm_setzero_ps();
+
+				for (int k = 0; k < taps; k++)
+				{
+					const __m128 coefficient = _mm_set1_ps(coefficients[k]);
+					low = _mm_add_ps(low, _mm_mul_ps(coefficient, _mm_loadu_ps(input + m - k)));
+					high = _mm_add_ps(high, _mm_mul_ps(coefficient, _mm_loadu_ps(input + m + 4 - k)));
+				}
+
+				float values[8];
+				_mm_storeu_ps(values, low);
+				_mm_storeu_ps(values + 4, high);
+				for (int j = 0; j < 8; j++)
+				{
+					out[(m + j) * factor + p] = values[j];
+				}
+			}
+		}
+
+		interpolateScalar(input + m, numInputs - m, factor, phases, taps, out + m * factor);
+	}
+
+	//==============================================================================
+	// AVX2
+	NOISE_TARGET_AVX2 static inline __m256i temperAVX2(__m256i y)
+	{
+		y = _mm256_xor_si256(y, _mm256_srli_epi32(y, 11));
+		y = _mm256_xor_si256(y, _mm256_and_si256(_mm256_slli_epi32(y, 7), _mm256_set1_epi32((int)0x9d2c5680u)));
+		y = _mm256_xor_si256(y, _mm256_and_si256(_mm256_slli_epi32(y, 15), _mm256_set1_epi32((int)0xefc60000u)));
+		return _mm256_xor_si256(y, _mm256_srli_epi32(y, 18));
+	}
+
+	NOISE_TARGET_AVX2 static inline __m256i mersenneStepAVX2(__m256i current, __m256i next, __m256i far)
+	{
+		const __m256i y = _mm256_or_si256(_mm256_and_si256(current, _mm256_set1_epi32((int)MT_UPPER_MASK)), _mm256_and_si256(next, _mm256_set1_epi32((int)MT_LOWER_MASK)));
+		const __m256i mag = _mm256_and_si256(_mm256_sub_epi32(_mm256_setzero_si256(), _mm256_and_si256(y, _mm256_set1_epi32(1))), _mm256_set1_epi32((int)MT_MATRIX_A));
+		return _mm256_xor_si256(_mm256_xor_si256(far, _mm256_srli_epi32(y, 1)), mag);
+	}
+
+	NOISE_TARGET_AVX2 static void fastNoiseAVX2(uint32_t* x1, uint32_t* x2, float* out, int numSamples, float gain)
+	{
+		const __m256 scale = _mm256_set1_ps(gain / 2147483647.0f);
+
+		__m256i a = _mm256_loadu_si256((const __m256i*)x1);
+		__m256i b = _mm256_loadu_si256((const __m256i*)x2);
+
+		int i = 0;
+		for (; i + LANES <= numSamples; i += LANES)
+		{
+			a = _mm256_xor_si256(a, b);
+			_mm256_storeu_ps(out + i, _mm256_mul_ps(scale, _mm256_cvtepi32_ps(b)));
+			b = _mm256_add_epi32(b, a);
+		}
+
+		_mm256_storeu_si256((__m256i*)x1, a);
+		_mm256_storeu_si256((__m256i*)x2, b);
+
+		_mm256_zeroupper();
+
+		fastNoiseScalar(x1, x2, out + i, numSamples - i, gain);
+	}
+
+	NOISE_TARGET_AVX2 static uint32_t lehmerAVX2(uint32_t state, uint32_t multiplier, uint32_t modulus, float* out, int numSamples, float gain)
+	{
+		if (numSamples < LANES)
+			return lehmerScalar(state, multiplier, modulus, out, numSamples, gain);
+
+		alignas(32) uint32_t lanes[LANES];
+		seedLanes(lanes, state, multiplier, 0u);
+
+		const __m256i mask = _mm256_set1_epi32((int)(modulus - 1u));
+		const __m256i step = _mm256_set1_epi32((int)power(multiplier, LANES));
+		const __m256 scale = _mm256_set1_ps(gain * 2.0f / (float)modulus);
+		const __m256 offset = _mm256_set1_ps(gain);
+
+		__m256i l = _mm256_and_si256(_mm256_load_si256((const __m256i*)lanes), mask);
+
+		int i = 0;
+		for (;;)
+		{
+			_mm256_storeu_ps(out + i, _mm256_sub_ps(_mm256_mul_ps(scale, _mm256_cvtepi32_ps(l)), offset));
+			i += LANES;
+
+			if (i + LANES > numSamples)
+				break;
+
+			l = _mm256_and_si256(_mm256_mullo_epi32(l, step), mask);
+		}
+
+		_mm256_store_si256((__m256i*)lanes, l);
+		_mm256_zeroupper();
+		return lehmerScalar(lanes[LANES - 1], multiplier, modulus, out + i, numSamples - i, gain);
+	}
+
+	NOISE_TARGET_AVX2 static uint32_t linearCongruentialAVX2(uint32_t state, uint32_t multiplier, uint32_t increment, float* out, int numSamples, float gain)
+	{
+		if (numSamples < LANES)
+			return linearCongruentialScalar(state, multiplier, increment, out, numSamples, gain);
+
+		alignas(32) uint32_t lanes[LANES];
+		seedLanes(lanes, state, multiplier, increment);
+
+		uint32_t stepIncrement = 0u;
+		for (int j = 0; j < LANES; j++)
+		{
+			stepIncrement = multiplier * stepIncrement + increment;
+		}
+
+		const __m256i stepMultiplier = _mm256_set1_epi32((int)power(multiplier, LANES));
+		const __m256i stepAdd = _mm256_set1_epi32((int)stepIncrement);
+		const __m256i mask = _mm256_set1_epi32(0x7fff);
+		const __m256 scale = _mm256_set1_ps(gain * 2.0f / 32767.0f);
+		const __m256 offset = _mm256_set1_ps(gain);
+
+		__m256i l = _mm256_load_si256((const __m256i*)lanes);
+
+		int i = 0;
+		for (;;)
+		{
+			_mm256_storeu_ps(out + i, _mm256_sub_ps(_mm256_mul_ps(scale, _mm256_cvtepi32_ps(_mm256_and_si256(_mm256_srli_epi32(l, 16), mask))), offset));
+			i += LANES;
+
+			if (i + LANES > numSamples)
+				break;
+
+			l = _mm256_add_epi32(_mm256_mullo_epi32(l, stepMultiplier), stepAdd);
+		}
+
+		_mm256_store_si256((__m256i*)lanes, l);
+		_mm256_zeroupper();
+		return linearCongruentialScalar(lanes[LANES - 1], multiplier, increment, out + i, numSamples - i, gain);
+	}
+
+	NOISE_TARGET_AVX2 static void mersenneTwistAVX2(uint32_t* mt)
+	{
+		const int N = MersenneTwister::N;
+
+		int i = 0;
+		for (; i + 8 <= N - (int)MT_M; i += 8)
+		{
+			const __m256i current = _mm256_loadu_si256((const __m256i*)(mt + i));
+			const __m256i next = _mm256_loadu_si256((const __m256i*)(mt + i + 1));
+			const __m256i far = _mm256_loadu_si256((const __m256i*)(mt + i + MT_M));
+			_mm256_storeu_si256((__m256i*)(mt + i), mersenneStepAVX2(current, next, far));
+		}
+		for (; i < N - (int)MT_M; i++)
+		{
+			mersenneStep(mt, i, i + 1, i + MT_M);
+		}
+
+		for (; i + 8 <= N - 1; i += 8)
+		{
+			const __m256i current = _mm256_loadu_si256((const __m256i*)(mt + i));
+			const __m256i next = _mm256_loadu_si256((const __m256i*)(mt + i + 1));
+			const __m256i far = _mm256_loadu_si256((const __m256i*)(mt + i + MT_M - N));
+			_mm256_storeu_si256((__m256i*)(mt + i), mersenneStepAVX2(current, next, far));
+		}
+		for (; i < N - 1; i++)
+		{
+			mersenneStep(mt, i, i + 1, i + MT_M - N);
+		}
+
+		mersenneStep(mt, N - 1, 0, MT_M - 1);
+	}
+
+	NOISE_TARGET_AVX2 static void mersenneUniformAVX2(const uint32_t* state, float* out, int numSamples, float gain)
+	{
+		const __m256i exponent = _mm256_set1_epi32(0x3f800000);
+		const __m256 scale = _mm256_set1_ps(2.0f * gain);
+		const __m256 offset = _mm256_set1_ps(3.0f * gain);
+
+		int i = 0;
+		for (; i + 8 <= numSamples; i += 8)
+		{
+			const __m256i y = temperAVX2(_mm256_loadu_si256((const __m256i*)(state + i)));
+			const __m256 f = _mm256_castsi256_ps(_mm256_or_si256(_mm256_srli_epi32(y, 9), exponent));
+			_mm256_storeu_ps(out + i, _mm256_sub_ps(_mm256_mul_ps(f, scale), offset));
+		}
+
+		_mm256_zeroupper();
+
+		mersenneUniformScalar(state + i, out + i, numSamples - i, gain);
+	}
+
+	NOISE_TARGET_AVX2 static void mersenneSignAVX2(const uint32_t* state, float* out, int numSamples, float gain)
+	{
+		const __m256i negativeGain = _mm256_castps_si256(_mm256_set1_ps(-gain));
+		const __m256i signBit = _mm256_set1_epi32((int)0x80000000u);
+
+		int i = 0;
+		for (; i + 8 <= numSamples; i += 8)
+		{
+			const __m256i y = temperAVX2(_mm256_loadu_si256((const __m256i*)(state + i)));
+			_mm256_storeu_ps(out + i, _mm256_castsi256_ps(_mm256_xor_si256(negativeGain, _mm256_and_si256(y, signBit))));
+		}
+
+		_mm256_zeroupper();
+
+		mersenneSignScalar(state + i, out + i, numSamples - i, gain);
+	}
+
+	NOISE_TARGET_AVX2 static void mersenneTemperAVX2(const uint32_t* state, uint32_t* out, int numSamples)
+	{
+		int i = 0;
+		for (; i + 8 <= numSamples; i += 8)
+		{
+			_mm256_storeu_si256((__m256i*)(out + i), temperAVX2(_mm256_loadu_si256((const __m256i*)(state + i))));
+		}
+
+		_mm256_zeroupper();
+
+		mersenneTemperScalar(state + i, out + i, numSamples - i);
+	}
+
+	NOISE_TARGET_AVX2 static inline void mulhilo32AVX2(__m256i a, __m256i multiplier, __m256i& high, __m256i& low)
+	{
+		const __m256i even = _mm256_shuffle_epi32(_mm256_mul_epu32(a, multiplier), _MM_SHUFFLE(3, 1, 2, 0));
+		const __m256i odd = _mm256_shuffle_epi32(_mm256_mul_epu32(_mm256_srli_epi64(a, 32), multiplier), _MM_SHUFFLE(3, 1, 2, 0));
+		low = _mm256_unpacklo_epi32(even, odd);
+		high = _mm256_unpackhi_epi32(even, odd);
+	}
+
+	NOISE_TARGET_AVX2 static void philoxAVX2(const uint32_t* key, uint64_t firstBlock, uint32_t* out, int numBlocks)
+	{
+		const __m256i m0 = _mm256_set1_epi32((int)PHILOX_M0);
+		const __m256i m1 = _mm256_set1_epi32((int)PHILOX_M1);
+
+		int b = 0;
+		for (; b + 8 <= numBlocks; b += 8)
+		{
+			uint32_t low[8];
+			uint32_t high[8];
+			for (int j = 0; j < 8; j++)
+			{
+				const uint64_t block = firstBlock + (uint64_t)(b + j);
+				low[j] = (uint32_t)block;
+				high[j] = (uint32_t)(block >> 32);
+			}
+
+			__m256i c0 = _mm256_loadu_si256((const __m256i*)low);
+			__m256i c1 = _mm256_loadu_si256((const __m256i*)high);
+			__m256i c2 = _mm256_setzero_si256();
+			__m256i c3 = _mm256_setzero_si256();
+			uint32_t k0 = key[0];
+			uint32_t k1 = key[1];
+
+			for (int round = 0; round < PHILOX_ROUNDS; round++)
+			{
+				__m256i high0, low0, high1, low1;
+				mulhilo32AVX2(c0, m0, high0, low0);
+				mulhilo32AVX2(c2, m1, high1, low1);
+
+				c0 = _mm256_xor_si256(_mm256_xor_si256(high1, c1), _mm256_set1_epi32((int)k0));
+				c1 = low1;
+				c2 = _mm256_xor_si256(_mm256_xor_si256(high0, c3), _mm256_set1_epi32((int)k1));
+				c3 = low0;
+
+				k0 += PHILOX_W0;
+				k1 += PHILOX_W1;
+			}
+
+			// Each 128 bit half transposes its own four blocks
+			const __m256i t0 = _mm256_unpacklo_epi32(c0, c1);
+			const __m256i t1 = _mm256_unpacklo_epi32(c2, c3);
+			const __m256i t2 = _mm256_unpackhi_epi32(c0, c1);
+			const __m256i t3 = _mm256_unpackhi_epi32(c2, c3);
+			const __m256i r0 = _mm256_unpacklo_epi64(t0, t1);
+			const __m256i r1 = _mm256_unpackhi_epi64(t0, t1);
+			const __m256i r2 = _mm256_unpacklo_epi64(t2, t3);
+			const __m256i r3 = _mm256_unpackhi_epi64(t2, t3);
+
+			_mm256_storeu_si256((__m256i*)(out + 4 * b), _mm256_permute2x128_si256(r0, r1, 0x20));
+			_mm256_storeu_si256((__m256i*)(out + 4 * b + 8), _mm256_permute2x128_si256(r2, r3, 0x20));
+			_mm256_storeu_si256((__m256i*)(out + 4 * b + 16), _mm256_permute2x128_si256(r0, r1, 0x31));
+			_mm256_storeu_si256((__m256i*)(out + 4 * b + 24), _mm256_permute2x128_si256(r2, r3, 0x31));
+		}
+
+		// Tail calls skip the automatic vzeroupper, dirty upper halves slow down
+		// the SSE code that consumes the bits
+		_mm256_zeroupper();
+
+		philoxScalar(key, firstBlock + (uint64_t)b, out + 4 * b, numBlocks - b);
+	}
+
+	// Entries are gathered field by field, five words apart
+	NOISE_TARGET_AVX2 static void aliasSampleAVX2(const AliasEntry* entries, uint32_t numBins, const uint32_t* bits, float* out, int numSamples, float gain)
+	{
+		static_assert(sizeof(AliasEntry) == 5 * sizeof(uint32_t), "AliasEntry is gathered as five words");
+
+		const float* fields = reinterpret_cast<const float*>(entries);
+		const __m256i bins = _mm256_set1_epi32((int)numBins);
+		const __m256i words = _mm256_set1_epi32(5);
+		const __m256i signBit = _mm256_set1_epi32((int)0x80000000u);
+		const __m256 gainVector = _mm256_set1_ps(gain);
+
+		int i = 0;
+		for (; i + 8 <= numSamples; i += 8)
+		{
+			__m256i entry, fraction;
+			mulhilo32AVX2(_mm256_loadu_si256((const __m256i*)(bits + i)), bins, entry, fraction);
+
+			const __m256i index = _mm256_mullo_epi32(entry, words);
+			const __m256i threshold = _mm256_i32gather_epi32((const int*)fields, index, 4);
+
+			// Unsigned fraction < threshold
+			const __m256i own = _mm256_cmpgt_epi32(_mm256_xor_si256(threshold, signBit), _mm256_xor_si256(fraction, signBit));
+			const __m256i offset = _mm256_sub_epi32(fraction, _mm256_andnot_si256(own, threshold));
+
+			const __m256 lower = _mm256_blendv_ps(_mm256_i32gather_ps(fields + 3, index, 4), _mm256_i32gather_ps(fields + 1, index, 4), _mm256_castsi256_ps(own));
+			const __m256 scale = _mm256_blendv_ps(_mm256_i32gather_ps(fields + 4, index, 4), _mm256_i32gather_ps(fields + 2, index, 4), _mm256_castsi256_ps(own));
+			const __m256 value = _mm256_add_ps(lower, _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_srli_epi32(offset, 1)), scale));
+
+			_mm256_storeu_ps(out + i, _mm256_mul_ps(value, gainVector));
+		}
+
+		_mm256_zeroupper();
+
+		aliasSampleScalar(entries, numBins, bits + i, out + i, numSamples - i, gain);
+	}
+
+	NOISE_TARGET_AVX2 static void multiplyRampAVX2(float* data, int numSamples, float start, float multiplier)
+	{
+		float powers[LANES];
+		const float step = rampPowers(multiplier, powers);
+		const __m256 powersVector = _mm256_loadu_ps(powers);
+		float base = start;
+
+		int i = 0;
+		for (; i + LANES <= numSamples; i += LANES)
+		{
+			_mm256_storeu_ps(data + i, _mm256_mul_ps(_mm256_loadu_ps(data + i), _mm256_mul_ps(_mm256_set1_ps(base), powersVector)));
+			base *= step;
+		}
+
+		for (int j = 0; i < numSamples; i++, j++)
+		{
+			data[i] *= base * powers[j];
+		}
+	}
+
+	NOISE_TARGET_AVX2 static void interpolateAVX2(const float* input, int numInputs, int factor, const float* phases, int taps, float* out)
+	{
+		// Two groups of lanes at once, one add chain alone would wait on its latency
+		int m = 0;
+		for (; m + 2 * LANES <= numInputs; m += 2 * LANES)
+		{
+			for (int p = 0; p < factor; p++)
+			{
+				const float* coefficients = phases + p * taps;
+				__m256 first = _mm256_setzero_ps();
+				__m256 second = _mm256_setzero_ps();
+
+				for (int k = 0; k < taps; k++)
+				{
+					const __m256 coefficient = _mm256_set1_ps(coefficients[k]);
+					first = _mm256_add_ps(first, _mm256_mul_ps(coefficient, _mm256_loadu_ps(input + m - k)));
+					second = _mm256_add_ps(second, _mm256_mul_ps(coefficient, _mm256_loadu_ps(input + m + LANES - k)));
+				}
+
+				float values[2 * LANES];
+				_mm256_storeu_ps(values, first);
+				_mm256_storeu_ps(values + LANES, second);
+				for (int j = 0; j < 2 * LANES; j++)
+				{
+					out[(m + j) * factor + p] = values[j];
+				}
+			}
+		}
+
+		_mm256_zeroupper();
+		interpolateScalar(input + m, numInputs - m, factor, phases, taps, out + m * factor);
+	}
+#endif
+
+	//==============================================================================
+	// Dispatch
+	struct KernelTable
+	{
+		InstructionSet instructionSet;
+		void (*fastNoise)(uint32_t*, uint32_t*, float*, int, float);
+		uint32_t (*lehmer)(uint32_t, uint32_t, uint32_t, float*, int, float);
+		uint32_t (*linearCongruential)(uint32_t, uint32_t, uint32_t, float*, int, float);
+		void (*mersenneTwist)(uint32_t*);
+		void (*mersenneUniform)(const uint32_t*, float*, int, float);
+		void (*mersenneSign)(const uint32_t*, float*, int, float);
+		void (*mersenneTemper)(const uint32_t*, uint32_t*, int);
+		void (*multiplyRamp)(float*, int, float, float);
+		void (*philox)(const uint32_t*, uint64_t, uint32_t*, int);
+		void (*aliasSample)(const AliasEntry*, uint32_t, const uint32_t*, float*, int, float);
+		void (*interpolate)(const float*, int, int, const float*, int, float*);
+	};
+
+	static const KernelTable scalarKernels = { Scalar, fastNoiseScalar, lehmerScalar, linearCongruentialScalar, mersenneTwistScalar, mersenneUniformScalar, mersenneSignScalar, mersenneTemperScalar, multiplyRampScalar, philoxScalar, aliasSampleScalar, interpolateScalar };
+#if NOISE_KERNELS_X86
+	static const KernelTable sse2Kernels = { SSE2, fastNoiseSSE2, lehmerSSE2, linearCongruentialSSE2, mersenneTwistSSE2, mersenneUniformSSE2, mersenneSignSSE2, mersenneTemperSSE2, multiplyRampSSE2, philoxSSE2, aliasSampleScalar, interpolateSSE2 };
+	static const KernelTable avx2Kernels = { AVX2, fastNoiseAVX2, lehmerAVX2, linearCongruentialAVX2, mersenneTwistAVX2, mersenneUniformAVX2, mersenneSignAVX2, mersenneTemperAVX2, multiplyRampAVX2, philoxAVX2, aliasSampleAVX2, interpolateAVX2 };
+#endif
+
+	static InstructionSet detectInstructionSet()
+	{
+#if NOISE_KERNELS_X86
+	#if defined(_MSC_VER)
+		int info[4];
+		__cpuid(info, 0);
+		const int maxLeaf = info[0];
+
+		__cpuid(info, 1);
+		const bool sse2 = (info[3] & (1 << 26)) != 0;
+		const bool osxsave = (info[2] & (1 << 27)) != 0;
+		const bool avx = (info[2] & (1 << 28)) != 0;
+
+		if (maxLeaf >= 7 && osxsave && avx && (_xgetbv(0) & 6) == 6)
+		{
+			__cpuidex(info, 7, 0);
+			if ((info[1] & (1 << 5)) != 0)
+				return AVX2;
+		}
+
+		return sse2 ? SSE2 : Scalar;
+	#else
+		__builtin_cpu_init();
+
+		if (__builtin_cpu_supports("avx2"))
+			return AVX2;
+		if (__builtin_cpu_supports("sse2"))
+			return SSE2;
+	#endif
+#endif
+		return Scalar;
+	}
+
+	static const KernelTable* getTable(InstructionSet instructionSet)
+	{
+#if NOISE_KERNELS_X86
+		if (instructionSet == AVX2)
+			return &avx2Kernels;
+		if (instructionSet == SSE2)
+			return &sse2Kernels;
+#endif
+		return &scalarKernels;
+	}
+
+	static std::atomic<const KernelTable*>& getKernels()
+	{
+		static std::atomic<const KernelTable*> kernels{ getTable(getBestInstructionSet()) };
+		return kernels;
+	}
+
+	//==============================================================================
+	InstructionSet getInstructionSet()
+	{
+		return getKernels().load(std::memory_order_relaxed)->instructionSet;
+	}
+
+	InstructionSet getBestInstructionSet()
+	{
+		static const InstructionSet best = detectInstructionSet();
+		return best;
+	}
+
+	void setInstructionSet(InstructionSet instructionSet)
+	{
+		if (instructionSet > getBestInstructionSet())
+			instructionSet = getBestInstructionSet();
+
+		getKernels().store(getTable(instructionSet), std::memory_order_relaxed);
+	}
+
+	void fastNoise(uint32_t* x1, uint32_t* x2, float* out, int numSamples, float gain)
+	{
+		getKernels().load(std::memory_order_relaxed)->fastNoise(x1, x2, out, numSamples, gain);
+	}
+
+	uint32_t lehmer(uint32_t state, uint32_t multiplier, uint32_t modulus, float* out, int numSamples, float gain)
+	{
+		return getKernels().load(std::memory_order_relaxed)->lehmer(state, multiplier, modulus, out, numSamples, gain);
+	}
+
+	uint32_t linearCongruential(uint32_t state, uint32_t multiplier, uint32_t increment, float* out, int numSamples, float gain)
+	{
+		return getKernels().load(std::memory_order_relaxed)->linearCongruential(state, multiplier, increment, out, numSamples, gain);
+	}
+
+	void mersenneTwist(uint32_t* state)
+	{
+		getKernels().load(std::memory_order_relaxed)->mersenneTwist(state);
+	}
+
+	void mersenneUniform(const uint32_t* state, float* out, int numSamples, float gain)
+	{
+		getKernels().load(std::memory_order_relaxed)->mersenneUniform(state, out, numSamples, gain);
+	}
+
+	void mersenneSign(const uint32_t* state, float* out, int numSamples, float gain)
+	{
+		getKernels().load(std::memory_order_relaxed)->mersenneSign(state, out, numSamples, gain);
+	}
+
+	void mersenneTemper(const uint32_t* state, uint32_t* out, int numSamples)
+	{
+		getKernels().load(std::memory_order_relaxed)->mersenneTemper(state, out, numSamples);
+	}
+
+	void multiplyRamp(float* data, int numSamples, float start, float multiplier)
+	{
+		getKernels().load(std::memory_order_relaxed)->multiplyRamp(data, numSamples, start, multiplier);
+	}
+
+	void philox(const uint32_t* key, uint64_t firstBlock, uint32_t* out, int numBlocks)
+	{
+		getKernels().load(std::memory_order_relaxed)->philox(key, firstBlock, out, numBlocks);
+	}
+
+	void aliasSample(const AliasEntry* entries, uint32_t numBins, const uint32_t* bits, float* out, int numSamples, float gain)
+	{
+		getKernels().load(std::memory_order_relaxed)->aliasSample(entries, numBins, bits, out, numSamples, gain);
+	}
+
+	void interpolate(const float* input, int numInputs, int factor, const float* phases, int taps, float* out)
+	{
+		getKernels().load(std::memory_order_relaxed)->interpolate(input, numInputs, factor, phases, taps, out);
+	}
+
+	void philoxBlock(const uint32_t* key, const uint32_t* counter, uint32_t* out)
+	{
+		uint32_t c0 = counter[0];
+		uint32_t c1 = counter[1];
+		uint32_t c2 = counter[2];
+		uint32_t c3 = counter[3];
+		uint32_t k0 = key[0];
+		uint32_t k1 = key[1];
+
+		for (int round = 0; round < PHILOX_ROUNDS; round++)
+		{
+			const uint64_t product0 = (uint64_t)PHILOX_M0 * c0;
+			const uint64_t product1 = (uint64_t)PHILOX_M1 * c2;
+
+			c0 = (uint32_t)(product1 >> 32) ^ c1 ^ k0;
+			c1 = (uint32_t)product1;
+			c2 = (uint32_t)(product0 >> 32) ^ c3 ^ k1;
+			c3 = (uint32_t)product0;
+
+			k0 += PHILOX_W0;
+			k1 += PHILOX_W1;
+		}
+
+		out[0] = c0;
+		out[1] = c1;
+		out[2] = c2;
+		out[3] = c3;
+	}
+}
+
+//==============================================================================
+// Mersenne Twister jump ahead, see Haramoto et al. "Efficient Jump Ahead for
+// F2-Linear Random Number Generators". A jump by J outputs is the polynomial
+// x^J mod phi(x) applied to the state.
+
+// Characteristic polynomial of MT19937, bit i is the coefficient of x^i
+static const uint32_t mersenneCharacteristic[MersenneTwister::N] =
+{
+	0x00000001u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u,
+	0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u,
+	0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u,
+	0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u,
+	0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000020u, 0x00000000u, 0x00000000u,
+	0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000100u, 0x00000000u, 0x00000000u, 0x00000000u,
+	0x00000000u, 0x00020000u, 0x00000000u, 0x00000800u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u,
+	0x00000000u, 0x00000000u, 0x00004000u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u,
+	0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u,
+	0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u, 0x20000000u, 0x00000000u, 0x00000000u,
+	0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00200000u, 0x00000000u,
+	0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u, 0x01000000u, 0x00000000u, 0x00000000u,
+	0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u, 0x08000000u, 0x00000000u, 0x00000000u, 0x00000000u,
+	0x00000000u, 0x00000000u, 0x00000000u, 0x40000000u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u,
+	0x00000000u, 0x00000000u, 0x00000000u, 0x00000002u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u,
+	0x00000000u, 0x00000000u, 0x00000010u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u,
+	0x00000000u, 0x00000080u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u,
+	0x00000400u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u,
+	0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00020000u, 0x00000000u, 0x00000000u, 0x00000000u,
+	0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u,
+	0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u,
+	0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u,
+	0x20000000u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u,
+	0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u,
+	0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000002u, 0x00000000u,
+	0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000200u, 0x00000000u, 0x00000000u,
+	0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u,
+	0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u, 0x02000000u, 0x00000000u,
+	0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u,
+	0x00000000u, 0x00200000u, 0x00000000u, 0x00000020u, 0x80000000u, 0x00000000u, 0x00000000u, 0x00000000u,
+	0x00000000u, 0x00000000u, 0x00000100u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u,
+	0x00000000u, 0x00000800u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u,
+	0x00004000u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u,
+	0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u,
+	0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u,
+	0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u,
+	0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u,
+	0x00000000u, 0x00000002u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u,
+	0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00002000u, 0x00000000u, 0x00020000u,
+	0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00010000u, 0x00000000u, 0x00000000u, 0x00000000u,
+	0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u,
+	0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000020u, 0x00000000u,
+	0x00000200u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000100u, 0x00000000u, 0x00000000u,
+	0x00000000u, 0x00000000u, 0x00020000u, 0x00000000u, 0x00200800u, 0x00000000u, 0x00008000u, 0x00000000u,
+	0x00000000u, 0x02000000u, 0x00000000u, 0x01004000u, 0x00000000u, 0x00000000u, 0x20000000u, 0x00000000u,
+	0x00000000u, 0x00000000u, 0x08000000u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000021u, 0x00000000u,
+	0x00000000u, 0x40000000u, 0x00000000u, 0x00000200u, 0x00000000u, 0x00000100u, 0x20000000u, 0x00000000u,
+	0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00200000u,
+	0x00000000u, 0x00008000u, 0x00000000u, 0x00000200u, 0x00000000u, 0x00000000u, 0x21000000u, 0x00000000u,
+	0x00000000u, 0x00000000u, 0x00001000u, 0x00000000u, 0x00000002u, 0x08000000u, 0x00000001u, 0x00200000u,
+	0x00000000u, 0x00000000u, 0x00000000u, 0x00000200u, 0x40000000u, 0x00000008u, 0x00000000u, 0x00000000u,
+	0x00000000u, 0x00000000u, 0x00020000u, 0x00000000u, 0x00000042u, 0x08000000u, 0x00000000u, 0x00200000u,
+	0x00000000u, 0x00000000u, 0x00000000u, 0x00000010u, 0x00000000u, 0x00000000u, 0x21000000u, 0x00000000u,
+	0x00000000u, 0x00000000u, 0x00000080u, 0x00000000u, 0x00000002u, 0x00000000u, 0x00000001u, 0x00200000u,
+	0x00000000u, 0x00000400u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u,
+	0x00002000u, 0x00000000u, 0x00000080u, 0x00000000u, 0x00000002u, 0x00000000u, 0x00000000u, 0x00210000u,
+	0x00000000u, 0x00000000u, 0x00000000u, 0x00000010u, 0x00000000u, 0x00000000u, 0x01080000u, 0x00000000u,
+	0x00002000u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000002u, 0x08400000u, 0x00000000u, 0x00000000u,
+	0x00000000u, 0x00000000u, 0x00000000u, 0x00000200u, 0x42000000u, 0x00000000u, 0x00080000u, 0x00000000u,
+	0x00002000u, 0x00000000u, 0x00000000u, 0x10000000u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00210000u,
+	0x00000000u, 0x00000000u, 0x80000000u, 0x00000000u, 0x02000000u, 0x00000000u, 0x01000000u, 0x00000000u,
+	0x00002000u, 0x00000000u, 0x00000004u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u,
+	0x00000000u, 0x00000020u, 0x80000000u, 0x00000000u, 0x02000000u, 0x00000000u, 0x00000000u, 0x00000000u,
+	0x00002100u, 0x00000000u, 0x00000000u, 0x10000000u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00010800u,
+	0x00000000u, 0x00000020u, 0x00000000u, 0x00000000u, 0x02000000u, 0x00000000u, 0x00084000u, 0x00000000u,
+	0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00420000u, 0x00000000u, 0x00000800u,
+	0x00000000u, 0x00000020u, 0x00000000u, 0x00000000u, 0x00100000u, 0x00000000u, 0x00000000u, 0x00000000u,
+	0x00000100u, 0x00000000u, 0x00000000u, 0x00800000u, 0x00000000u, 0x00020000u, 0x00000000u, 0x00000000u,
+	0x00000000u, 0x00000020u, 0x04000000u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u,
+	0x00000000u, 0x20000000u, 0x00000000u, 0x00800000u, 0x00000000u, 0x00020000u, 0x00000000u, 0x00000000u,
+	0x00000000u, 0x00000001u, 0x00000000u, 0x00000000u, 0x00100000u, 0x00000000u, 0x00000000u, 0x00000000u,
+	0x00000008u, 0x20000000u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000040u,
+	0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000200u, 0x00000000u,
+	0x00000008u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00001000u, 0x00000000u, 0x00000000u,
+	0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00008000u, 0x00000000u, 0x00000000u, 0x00000000u,
+	0x00000000u, 0x00000000u, 0x00000000u, 0x00040000u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u,
+	0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u,
+	0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u, 0x00000002u
+};
+
+// x^(2^64) mod phi(x)
+static const uint32_t mersenneJump64[MersenneTwister::N] =
+{
+	0x4c900f63u, 0xe248a4cdu, 0x75555aadu, 0x02c5e162u, 0x775322f2u, 0xcc7bdd4bu, 0xb071299bu, 0xff847763u,
+	0x54b43fbfu, 0x2dcb3bfbu, 0x5fcb8c34u, 0xe20b4cefu, 0xe2f9e066u, 0x53addb77u, 0x3fd01081u, 0x8b338d5eu,
+	0xfe42e658u, 0xd91e533au, 0x6795d7abu, 0x67f86694u, 0x7ba281b4u, 0xb29b5434u, 0x669bafb9u, 0x994909c5u,
+	0x6230ab31u, 0x9358444cu, 0x14341071u, 0xc3a7858fu, 0x675b2dd2u, 0x2d1e088cu, 0x8649eb5eu, 0x41bcbeddu,
+	0x90116aeeu, 0x47de650fu, 0x8b5a7d3eu, 0x08e74650u, 0x1d6d8688u, 0xf0495cfbu, 0x3ffa7ec4u, 0xa1fec000u,
+	0x303bd030u, 0x83d63538u, 0x583e3fa3u, 0x077fdaefu, 0x0bb4f1efu, 0x21f80583u, 0xc44df85cu, 0x873a5d43u,
+	0x4c18f526u, 0xe981be93u, 0x7bf02815u, 0xd95d2fa7u, 0xb1ddba06u, 0x4f52cb02u, 0xae86e7bfu, 0x23156bfbu,
+	0x15db9670u, 0xed5b6b38u, 0xe5ffdd1du, 0x6608c09du, 0xb0f29645u, 0x87d4b039u, 0x7775ae02u, 0xb370a1a9u,
+	0x47986568u, 0xc6a6464cu, 0xf304978du, 0xe2b2d815u, 0x15cb3159u, 0xd89aaa5bu, 0x17439b18u, 0x37969348u,
+	0xe7cd403eu, 0xe27dba9bu, 0xade001a8u, 0x49502803u, 0x7d161005u, 0x6300bd73u, 0x76a4c88bu, 0x7ee8b962u,
+	0x2647a4c1u, 0x77fef87eu, 0x7be21372u, 0x0f9c923eu, 0xa6e0b548u, 0x9b618fe8u, 0xdae91cf5u, 0xa284f483u,
+	0x070f14b0u, 0xb67b9f26u, 0x33809a23u, 0x93bece6cu, 0x30f58808u, 0x65e268f8u, 0x25bd5588u, 0x94628de0u,
+	0xce5b2d08u, 0x4eac9219u, 0xd5482eb5u, 0xbdc27b2fu, 0x37cd85acu, 0xa696a9f4u, 0x0ba18097u, 0x9cfbc28du,
+	0xe2d8d1d2u, 0x2de7c4d5u, 0x926ef804u, 0xf1d29bddu, 0xe8019c4bu, 0xc54262b9u, 0xbc8f76f7u, 0x10033bf8u,
+	0xb5966524u, 0x6c62cbbau, 0xc6598499u, 0xf1c9975fu, 0xdc52d11du, 0x02295d93u, 0x923b6811u, 0xa06ea369u,
+	0x331d5badu, 0x50dacd95u, 0x186e30dfu, 0x0f2787c9u, 0xea1e6941u, 0x25ca723au, 0x04764cc9u, 0x1b38c599u,
+	0x0efaf769u, 0x0e882a64u, 0x67ab43ffu, 0x2c07de2cu, 0x4047a8d7u, 0x6a4e6204u, 0x4b0f81deu, 0x9e50e39bu,
+	0xbd96c036u, 0xce36794fu, 0xe84dafd5u, 0x3a8d8d7bu, 0xc5cba176u, 0x30bc102cu, 0xce93dbf9u, 0x6dcc2704u,
+	0x697c8140u, 0xa4039adau, 0x957299e8u, 0x3edfba6eu, 0x721622beu, 0x4526e870u, 0x2a0cacfeu, 0x5bc71910u,
+	0xb52142dbu, 0xb1b32c82u, 0x381814d2u, 0x816f9d8cu, 0xfd6b3731u, 0x9f59cc3eu, 0xebfd2dfau, 0x6be77cdbu,
+	0xd2870108u, 0xa21b0fb7u, 0x0507c199u, 0x88155c26u, 0x7d0cf5e3u, 0xe0990dc6u, 0x415482a7u, 0x9842027bu,
+	0xf6f21a2eu, 0x8ec8063bu, 0xa512e19bu, 0x0ca3c754u, 0x0f37f158u, 0xe60b8a5bu, 0xc43f6ce4u, 0x3d1dbe43u,
+	0xf3b1f4bcu, 0x853ac8b5u, 0xf5849b5cu, 0xbc6b9349u, 0xb9269dddu, 0xeee13d2au, 0xd4a643d0u, 0xec1b7b91u,
+	0x71a29981u, 0xab378fc9u, 0x888b055du, 0x256bd757u, 0x6fdfe309u, 0x84e868c9u, 0x5f9a5801u, 0xae118d8bu,
+	0xc0e498c3u, 0x39c33c41u, 0x1645526fu, 0x9c8a68dfu, 0xfad14f7du, 0x93f5ac29u, 0x6546e3cbu, 0xa62e2fd3u,
+	0xd731bb47u, 0x89e78998u, 0x90d44d69u, 0xa43bffafu, 0x72226472u, 0x0d95beb0u, 0x2fbca613u, 0x455441e7u,
+	0x02c39885u, 0xd56aaed5u, 0xa9ffad44u, 0x4a8bdeceu, 0xa2e37cefu, 0xa8e0152eu, 0x37532471u, 0xa55abe6au,
+	0xda2580fdu, 0xad89bf65u, 0xcc2a3decu, 0x7ec360b1u, 0xc1f52676u, 0x3c4ae863u, 0x088f2b9eu, 0xe7c47ea0u,
+	0x80101c06u, 0x69b35de1u, 0x0fb8e1fau, 0xdb62d3f7u, 0x475cba2au, 0xb1507762u, 0x9b30ad26u, 0xe9094581u,
+	0xfea6ac93u, 0x6def9364u, 0xe86cbc87u, 0x9462f53fu, 0x41907f1eu, 0x40e02bbau, 0x0bdb91a2u, 0x93cc884au,
+	0x399d4499u, 0x9e66cba2u, 0x1b91f776u, 0xfaf29945u, 0x04c72d6fu, 0x7a599a2fu, 0x1c249235u, 0x4f0432ceu,
+	0x293afeb2u, 0x5d41d6d8u, 0x7f1e8c00u, 0x7677224fu, 0x231c2121u, 0x6b228fa3u, 0xc4a6232du, 0xaa196a04u,
+	0xe297285eu, 0x5396936fu, 0xdb8d384fu, 0x78ddefafu, 0x49a235d1u, 0x5742fc47u, 0xf43212cbu, 0x415f3088u,
+	0xb73bd17bu, 0x15bc30d1u, 0x5fc9b71au, 0xc5dcb8bbu, 0x05ae1d2cu, 0x1460f680u, 0xd696d1e0u, 0xda2c4681u,
+	0x6cf86b69u, 0x512d7565u, 0x775e98b7u, 0x166d0f83u, 0x0e55f238u, 0x2d3edf2bu, 0xf26af179u, 0xe839f1f4u,
+	0x1a858d2fu, 0x6c129576u, 0x41dd69aeu, 0xf290c59bu, 0x9bbc0ba4u, 0x504b9c71u, 0x87492c1fu, 0x5fee67d4u,
+	0x90078f7eu, 0x4f3d6ae8u, 0x461f3a63u, 0x5a3ce52bu, 0xf0e76abdu, 0x65f1a23bu, 0x28cca53fu, 0xbb141418u,
+	0x0add6cb2u, 0x5e2bbe79u, 0x4dcc0078u, 0xb68fc91eu, 0xca0013f1u, 0xac64ca4fu, 0x691fddd7u, 0xe7d10431u,
+	0xd92c0753u, 0xe86a25f7u, 0x5a461809u, 0xef3320d3u, 0x65b41bdfu, 0x4e76e28bu, 0x59d977dcu, 0x4a01d87cu,
+	0xfa9fd02du, 0xf29e02d5u, 0x1db02d91u, 0xb44fbc42u, 0x86411ddfu, 0x9a6b3f1cu, 0xa6cf8c46u, 0x35012893u,
+	0x8b855699u, 0xd3ee76fdu, 0x3cbbfbd4u, 0x16a5985cu, 0x6a0ae8d5u, 0x18847417u, 0xbfc1110bu, 0xf56822cfu,
+	0x6d70d28du, 0x10f92574u, 0xf18dcd35u, 0xa089b795u, 0x75dc1450u, 0x8516795au, 0x4848e61du, 0x8a635702u,
+	0x6f483f4fu, 0x4eca3ef1u, 0xa4c13207u, 0x38b2aca4u, 0x5e44190fu, 0x9cc2d2e9u, 0x7786a96eu, 0xe30ebc81u,
+	0x44959f76u, 0xb5b659afu, 0x725f717fu, 0x700f6c1fu, 0x1b4504bfu, 0x75a3b6d1u, 0x62dee734u, 0x295ac88au,
+	0x20855e36u, 0x98963dcbu, 0xc9b21ca4u, 0xaf120eebu, 0x8c429af4u, 0x6a8d016fu, 0xd2f60b19u, 0x641df9d8u,
+	0xf1364e2bu, 0xe4305d1fu, 0xfeed5c19u, 0xfee5b1d0u, 0x4ef7a165u, 0x3f54b57cu, 0x46cf7905u, 0xf36669a7u,
+	0x68798550u, 0x0f6b7150u, 0xd237fcaeu, 0x23615cbbu, 0x9a91c20fu, 0x3d63ccbeu, 0xd68b5562u, 0x84fc17dfu,
+	0x1913e423u, 0x231357a9u, 0x6fdc5382u, 0xeaaed948u, 0x4b0881fcu, 0x5617e641u, 0xee52947du, 0x16d86236u,
+	0x8cbc11fcu, 0x7fdb870bu, 0x50b6f9d4u, 0x47491ac6u, 0xbb79ca1au, 0x15272d87u, 0xd0ca7ec3u, 0xbf094ca5u,
+	0x93f2ca6cu, 0xb99feb61u, 0xb3b6122au, 0xe6451411u, 0xe708fed4u, 0x8ae9ddb8u, 0xfae77a3eu, 0xb87bc4fcu,
+	0x38839d5cu, 0x756264e5u, 0xbdc43032u, 0xa758307fu, 0x070adfa6u, 0xe6eac433u, 0xc5a37f43u, 0xcda88b18u,
+	0xe4d4cd3au, 0x89253009u, 0xaff05ff6u, 0xfd0fba0bu, 0x4935461bu, 0x756d1c49u, 0x1367c444u, 0xabca2abdu,
+	0x21474f38u, 0x37949cecu, 0xf6323d3du, 0xb7cda569u, 0xde01958eu, 0x8dd8b80du, 0x00c355b9u, 0xab317115u,
+	0xf9e5d127u, 0x150f3c15u, 0xa73a49a8u, 0x9a0dbb6fu, 0x95080193u, 0x4b304002u, 0x87749f7au, 0xa6a3653au,
+	0xc1dbf50au, 0x14539309u, 0xadf8d6c2u, 0xfd743599u, 0x0d51bf45u, 0x94e2ba74u, 0x98624e76u, 0xe15c57a3u,
+	0x6125aec8u, 0xddfa32b9u, 0x75b67b0fu, 0x469ace66u, 0x01abdab4u, 0x50b3b5b6u, 0x00b0e85bu, 0xbb1b7ae1u,
+	0xd6b52b08u, 0x604f2a45u, 0x061081abu, 0xf40cbde5u, 0x54eba670u, 0xf29c6626u, 0x3be4b068u, 0x74f2bc55u,
+	0x1e31fc36u, 0x077e35a6u, 0xc92288e1u, 0x70c92e17u, 0x0f071907u, 0xaed3a539u, 0x35354b44u, 0x116a44fcu,
+	0xfb89895eu, 0xd8c426abu, 0xefca9c61u, 0x6a085ea2u, 0x4a905b2cu, 0x93583af1u, 0xd8e56221u, 0x977c1318u,
+	0xf118add4u, 0x5349a011u, 0x8b6c9b1eu, 0x6cfcceddu, 0xabc7e67fu, 0xb15fdb98u, 0x5ef3dc9eu, 0xa554a816u,
+	0x11232427u, 0x5fb8dff6u, 0x45662685u, 0x9b49e507u, 0xcd009967u, 0x0b955a98u, 0x778e01c4u, 0x6c9e13a6u,
+	0x3167b338u, 0x7974a19eu, 0x66bceeebu, 0xa8bfcd35u, 0x4f89c9d3u, 0xe8dee989u, 0xf8802348u, 0xa61b2e07u,
+	0x969a48f2u, 0x32d550c2u, 0xdc755365u, 0x8ef0ab44u, 0x50e48f6eu, 0x4fc059cau, 0xcf4fbf2eu, 0xebe837c5u,
+	0x66a955ccu, 0x8b33c56bu, 0xd78e0a73u, 0x90c2604fu, 0x71db1d82u, 0xde124fffu, 0x78f30ba4u, 0xa62c6e0eu,
+	0xad72dd6au, 0x15c9b8ceu, 0x4670f152u, 0xaf42ad0fu, 0xe6f8a792u, 0x7c3eca52u, 0x671d8003u, 0x27f2396cu,
+	0xf369c598u, 0xb5511a05u, 0xe792aa51u, 0x3e40c35du, 0x4fdebf0bu, 0x05a8ba07u, 0x15d7d9c3u, 0x5c75f817u,
+	0x6cb1c6e1u, 0xf769e5d1u, 0xd20d8531u, 0xa26b4d0du, 0xa91cdb5fu, 0x90532c00u, 0x400128bdu, 0x70ea2cd4u,
+	0x9c9b4320u, 0xf6f962e9u, 0x8d80ed7eu, 0x296d79f9u, 0xab8e062eu, 0x2863459fu, 0xde116573u, 0x340ff74au,
+	0x9eb8522eu, 0x86912eddu, 0xbfddd205u, 0x2e2efb3cu, 0x3ce0ace4u, 0xd8579cbfu, 0x5cb1afb1u, 0x9886f603u,
+	0x23ec32e8u, 0x35548503u, 0x8b738a7cu, 0x87dd0ce1u, 0x669d9df9u, 0x70330c59u, 0x9263e2b7u, 0xeb7c539fu,
+	0x149893e2u, 0x35bc025eu, 0x547a177au, 0x72d3ae49u, 0x85c4fea0u, 0x7ccf0650u, 0x710edc8du, 0xf8e109f2u,
+	0xc105573cu, 0x77a63a3du, 0x80c6b444u, 0x78f7d5c0u, 0xf741c57bu, 0x431a5704u, 0x5a3ffa09u, 0x2efa4d31u,
+	0xd945c460u, 0xd4ad0e3eu, 0x794d31adu, 0x3085a588u, 0xbcfb9832u, 0x903ce960u, 0x1e66d62du, 0x3fda53bcu,
+	0x5bdcf1d6u, 0x383c9eb7u, 0x411a11f9u, 0x9581cebcu, 0x8a46dd4cu, 0x4f2e925cu, 0x57fb207eu, 0x126215f8u,
+	0xf5ef34fau, 0xd8d98c17u, 0x657a3b9cu, 0x8bddb9fau, 0x27da1a8fu, 0xa63fa026u, 0x7b2682d6u, 0x6273b291u,
+	0x48b3213bu, 0xf7ded422u, 0x26ba215du, 0x30ec90eau, 0x257a9cf5u, 0x0cbdd6c3u, 0x29ea26c1u, 0x4a542ebcu,
+	0x2f70bad6u, 0xb1d505fcu, 0x77f48b79u, 0x7e3c2bdau, 0x5b1d3682u, 0x669f1520u, 0x0ab77d26u, 0x71fd8207u,
+	0x9d9efbfbu, 0x1aaa1bd6u, 0x883f5d32u, 0x5e9cf61bu, 0x03f0b0cbu, 0x0e423384u, 0x10a7a774u, 0x00000000u
+};
+
+static inline uint64_t spreadBits(uint32_t x)
+{
+	uint64_t v = x;
+	v = (v | (v << 16)) & 0x0000ffff0000ffffull;
+	v = (v | (v << 8)) & 0x00ff00ff00ff00ffull;
+	v = (v | (v << 4)) & 0x0f0f0f0f0f0f0f0full;
+	v = (v | (v << 2)) & 0x3333333333333333ull;
+	v = (v | (v << 1)) & 0x5555555555555555ull;
+	return v;
+}
+
+// out = in^2 mod phi(x)
+static void squareModulo(const uint32_t* in, uint32_t* out)
+{
+	const int N = MersenneTwister::N;
+	const int DEGREE = MersenneTwister::DEGREE;
+
+	// phi(x) shifted by 0..31 bits, so every reduction step is a word aligned xor
+	static uint32_t shiftedCharacteristic[32][N + 1];
+	static std::once_flag shiftedFlag;
+	std::call_once(shiftedFlag, []()
+	{
+		for (int shift = 0; shift < 32; shift++)
+		{
+			shiftedCharacteristic[shift][0] = mersenneCharacteristic[0] << shift;
+			for (int k = 1; k < N; k++)
+			{
+				shiftedCharacteristic[shift][k] = (mersenneCharacteristic[k] << shift) | (shift > 0 ? mersenneCharacteristic[k - 1] >> (32 - shift) : 0u);
+			}
+			shiftedCharacteristic[shift][N] = shift > 0 ? mersenneCharacteristic[N - 1] >> (32 - shift) : 0u;
+		}
+	});
+
+	uint32_t wide[2 * N];
+	for (int k = 0; k < N; k++)
+	{
+		const uint64_t spread = spreadBits(in[k]);
+		wide[2 * k] = (uint32_t)spread;
+		wide[2 * k + 1] = (uint32_t)(spread >> 32);
+	}
+
+	for (int bit = 2 * (DEGREE - 1); bit >= DEGREE; bit--)
+	{
+		if ((wide[bit >> 5] >> (bit & 31)) & 1u)
+		{
+			const int shift = bit - DEGREE;
+			const uint32_t* source = shiftedCharacteristic[shift & 31];
+			uint32_t* destination = wide + (shift >> 5);
+
+			for (int k = 0; k <= N; k++)
+			{
+				destination[k] ^= source[k];
+			}
+		}
+	}
+
+	memcpy(out, wide, sizeof(uint32_t) * N);
+}
+
+// Polynomial for a jump by 2^(64 + bit), squared up from mersenneJump64 on first use
+static const uint32_t* getStreamJump(int bit)
+{
+	static uint32_t polynomials[32][MersenneTwister::N];
+	static int count = 0;
+	static std::mutex mutex;
+
+	std::lock_guard<std::mutex> lock(mutex);
+
+	if (count == 0)
+	{
+		memcpy(polynomials[0], mersenneJump64, sizeof(mersenneJump64));
+		count = 1;
+	}
+
+	for (; count <= bit; count++)
+	{
+		squareModulo(polynomials[count - 1], polynomials[count]);
+	}
+
+	return polynomials[bit];
+}
+
+void MersenneTwister::setStream(uint32_t seed, uint32_t stream)
+{
+	// Counter word 3 is never set by Philox::processBits or PhiloxEngine, so the
+	// state shares no words with the counter mode paths of the same key
+	const uint32_t key[2] = { seed, stream };
+	for (int i = 0; i < N; i += 4)
+	{
+		const uint32_t counter[4] = { (uint32_t)i, 0u, 0u, 1u };
+		NoiseKernels::philoxBlock(key, counter, m_state + i);
+	}
+
+	m_index = N;
+}
+
+void MersenneTwister::setJumpedStream(uint32_t seed, uint32_t stream)
+{
+	setSeed(seed);
+
+	for (int bit = 0; bit < 32; bit++)
+	{
+		if ((stream >> bit) & 1u)
+			jump(getStreamJump(bit));
+	}
+}
+
+void MersenneTwister::jump(const uint32_t* polynomial)
+{
+	// Only called right after seeding, where m_index == N and m_state holds the
+	// last N words in order. The window slides along a buffer twice that size,
+	// so summing it up is one contiguous loop.
+	uint32_t buffer[2 * N];
+	uint32_t sum[N];
+	memcpy(buffer, m_state, sizeof(m_state));
+	memset(sum, 0, sizeof(sum));
+
+	int position = 0;
+
+	for (int i = 0; i < DEGREE; i++)
+	{
+		const uint32_t* window = buffer + position;
+
+		if ((polynomial[i >> 5] >> (i & 31)) & 1u)
+		{
+			for (int k = 0; k < N; k++)
+			{
+				sum[k] ^= window[k];
+			}
+		}
+
+		const uint32_t y = (window[0] & NoiseKernels::MT_UPPER_MASK) | (window[1] & NoiseKernels::MT_LOWER_MASK);
+		buffer[position + N] = window[NoiseKernels::MT_M] ^ (y >> 1) ^ ((0u - (y & 1u)) & NoiseKernels::MT_MATRIX_A);
+
+		if (++position == N)
+		{
+			memcpy(buffer, buffer + N, sizeof(m_state));
+			position = 0;
+		}
+	}
+
+	memcpy(m_state, sum, sizeof(sum));
+	m_index = N;
+}
+
+//==============================================================================
+void Philox::processBits(uint64_t position, uint32_t* out, int numWords) const
+{
+	uint32_t words[4];
+
+	// Rest of a block started before position
+	const int offset = (int)(position & 3u);
+	if (offset != 0 && numWords > 0)
+	{
+		const uint32_t counter[4] = { (uint32_t)(position >> 2), (uint32_t)(position >> 34), 0u, 0u };
+		NoiseKernels::philoxBlock(m_key, counter, words);
+
+		const int count = 4 - offset < numWords ? 4 - offset : numWords;
+		memcpy(out, words + offset, (size_t)count * sizeof(uint32_t));
+
+		position += (uint64_t)count;
+		out += count;
+		numWords -= count;
+	}
+
+	const int blocks = numWords / 4;
+	NoiseKernels::philox(m_key, position >> 2, out, blocks);
+
+	position += 4u * (uint64_t)blocks;
+	out += 4 * blocks;
+	numWords -= 4 * blocks;
+
+	if (numWords > 0)
+	{
+		const uint32_t counter[4] = { (uint32_t)(position >> 2), (uint32_t)(position >> 34), 0u, 0u };
+		NoiseKernels::philoxBlock(m_key, counter, words);
+		memcpy(out, words, (size_t)numWords * sizeof(uint32_t));
+	}
+}
+
+//==============================================================================
+// Vose's variant of Walker's method, every bin ends up holding its own share up
+// to its threshold and one alias for the rest
+void AliasTable::build(const float* weights, int numBins)
+{
+	numBins = numBins < 1 ? 1 : numBins > MAX_BINS ? MAX_BINS : numBins;
+
+	m_numBins = numBins;
+	m_weights.assign(weights, weights + numBins);
+
+	double sum = 0.0;
+	for (auto& weight : m_weights)
+	{
+		weight = weight > 0.0f ? weight : 0.0f;
+		sum += weight;
+	}
+
+	// All zero is taken as flat
+	std::vector<double> scaled((size_t)numBins, 1.0);
+	for (int bin = 0; sum > 0.0 && bin < numBins; bin++)
+	{
+		scaled[(size_t)bin] = m_weights[(size_t)bin] * numBins / sum;
+	}
+
+	// Full bins are their own alias
+	std::vector<uint32_t> thresholds((size_t)numBins, 0xffffffffu);
+	std::vector<int> aliases((size_t)numBins);
+	std::vector<int> small;
+	std::vector<int> large;
+
+	for (int bin = 0; bin < numBins; bin++)
+	{
+		aliases[(size_t)bin] = bin;
+		(scaled[(size_t)bin] < 1.0 ? small : large).push_back(bin);
+	}
+
+	while (!small.empty() && !large.empty())
+	{
+		const int less = small.back();
+		const int more = large.back();
+		small.pop_back();
+
+		thresholds[(size_t)less] = (uint32_t)(scaled[(size_t)less] * 4294967296.0);
+		aliases[(size_t)less] = more;
+
+		scaled[(size_t)more] -= 1.0 - scaled[(size_t)less];
+		if (scaled[(size_t)more] < 1.0)
+		{
+			large.pop_back();
+			small.push_back(more);
+		}
+	}
+
+	// Fractions are spread linearly over the bin they land in, halved so they
+	// convert as signed
+	const double width = 2.0 / numBins;
+	m_entries.resize((size_t)numBins);
+
+	for (int bin = 0; bin < numBins; bin++)
+	{
+		const uint32_t threshold = thresholds[(size_t)bin];
+		auto& entry = m_entries[(size_t)bin];
+
+		entry.threshold = threshold;
+		entry.lower = (float)(-1.0 + bin * width);
+		entry.scale = threshold > 0u ? (float)(2.0 * width / threshold) : 0.0f;
+		entry.aliasLower = (float)(-1.0 + aliases[(size_t)bin] * width);
+		entry.aliasScale = (float)(2.0 * width / (4294967296.0 - threshold));
+	}
+}
+
+const AliasTable& AliasTable::getDefault()
+{
+	static const AliasTable table = []()
+	{
+		// Bins of 0.1, nine per outer piece and two for the middle one
+		float weights[20];
+		for (int bin = 0; bin < 20; bin++)
+		{
+			weights[bin] = (bin == 9 || bin == 10) ? 15.0f / 2.0f : 1.0f / 18.0f;
+		}
+
+		AliasTable defaultTable;
+		defaultTable.build(weights, 20);
+		return defaultTable;
+	}();
+
+	return table;
+}
@@ -11,19 +11,526 @@
 #pragma once
 
 #include <stdlib.h>
+#include <stdint.h>
 #include <math.h>
 #include <random>
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <vector>
 
 //==============================================================================
+// Block kernels, implemented in NoiseGenerator.cpp with SSE2/AVX2 variants picked
+// at runtime. All variants produce identical output, so the instruction set
+// only changes speed.
+namespace NoiseKernels
+{
+	enum InstructionSet
+	{
+		Scalar,
+		SSE2,
+		AVX2
+	};
+
+	// Fast paths run this many interleaved lanes
+	static const int LANES = 8;
+
+	InstructionSet getInstructionSet();
+	InstructionSet getBestInstructionSet();
+	void setInstructionSet(InstructionSet instructionSet);
+
+	// Maps 32 random bits to [-1, 1) using the top 23 bits as mantissa
+	inline float bitsToFloat(uint32_t bits)
+	{
+		union { uint32_t i; float f; } u;
+		u.i = (bits >> 9) | 0x3f800000u;
+		return 2.0f * u.f - 3.0f;
+	}
+	// Same mapping with all 32 bits, the signed convert vectorises where unsigned does not
+	inline double bitsToDouble(uint32_t bits)
+	{
+		return (double)(int32_t)(bits ^ 0x80000000u) * (1.0 / 2147483648.0);
+	}
+
+	inline uint32_t temper(uint32_t y)
+	{
+		y ^= (y >> 11);
+		y ^= (y << 7) & 0x9d2c5680u;
+		y ^= (y << 15) & 0xefc60000u;
+		y ^= (y >> 18);
+		return y;
+	}
+
+	// Advances x = multiplier * x + increment (mod 2^32) by steps in O(log steps)
+	inline uint32_t affineJump(uint32_t state, uint32_t multiplier, uint32_t increment, unsigned long long steps)
+	{
+		uint32_t accMultiplier = 1u;
+		uint32_t accIncrement = 0u;
+
+		while (steps > 0)
+		{
+			if (steps & 1u)
+			{
+				accMultiplier *= multiplier;
+				accIncrement = accIncrement * multiplier + increment;
+			}
+
+			increment = (multiplier + 1u) * increment;
+			multiplier *= multiplier;
+			steps >>= 1;
+		}
+
+		return accMultiplier * state + accIncrement;
+	}
+
+	void fastNoise(uint32_t* x1, uint32_t* x2, float* out, int numSamples, float gain);
+	uint32_t lehmer(uint32_t state, uint32_t multiplier, uint32_t modulus, float* out, int numSamples, float gain);
+	uint32_t linearCongruential(uint32_t state, uint32_t multiplier, uint32_t increment, float* out, int numSamples, float gain);
+	void mersenneTwist(uint32_t* state);
+	void mersenneUniform(const uint32_t* state, float* out, int numSamples, float gain);
+	void mersenneSign(const uint32_t* state, float* out, int numSamples, float gain);
+	void mersenneTemper(const uint32_t* state, uint32_t* out, int numSamples);
+
+	// data[i] *= start * multiplier^i, powers are built per block of LANES
+	// samples so every variant rounds the same way
+	void multiplyRamp(float* data, int numSamples, float start, float multiplier);
+
+	// Polyphase interpolation by factor, out[m * factor + p] is the dot product of
+	// phase p with input[m], input[m - 1] ... input[m - taps + 1]. Phases hold taps
+	// coefficients each, input needs taps - 1 samples of history before it.
+	void interpolate(const float* input, int numInputs, int factor, const float* phases, int taps, float* out);
+
+	// Philox4x32-10 (Salmon et al., "Parallel Random Numbers: As Easy as 1, 2, 3"),
+	// four words per 128 bit counter. philox() runs counters firstBlock onwards, top 64 bits zero.
+	void philoxBlock(const uint32_t* key, const uint32_t* counter, uint32_t* out);
+	void philox(const uint32_t* key, uint64_t firstBlock, uint32_t* out, int numBlocks);
+
+	// Bin of an alias table, fractions below threshold land in the bin itself and
+	// the rest in its alias, each spread linearly from its lower edge
+	struct AliasEntry
+	{
+		uint32_t threshold;
+		float lower;
+		float scale;
+		float aliasLower;
+		float aliasScale;
+	};
+
+	// High half of bits * numBins picks the entry, the low half is the fraction
+	inline float aliasSample(const AliasEntry* entries, uint32_t numBins, uint32_t bits)
+	{
+		const uint64_t scaled = (uint64_t)bits * (uint64_t)numBins;
+		const AliasEntry& entry = entries[(size_t)(scaled >> 32)];
+		const uint32_t fraction = (uint32_t)scaled;
+
+		// Selects instead of a branch, both ways are about as likely. The offset is
+		// halved so it converts as signed.
+		const bool own = fraction < entry.threshold;
+		const uint32_t offset = own ? fraction : fraction - entry.threshold;
+		const float lower = own ? entry.lower : entry.aliasLower;
+		const float scale = own ? entry.scale : entry.aliasScale;
+
+		return lower + (float)(int32_t)(offset >> 1) * scale;
+	}
+	void aliasSample(const AliasEntry* entries, uint32_t numBins, const uint32_t* bits, float* out, int numSamples, float gain);
+}
+
+//==============================================================================
+// Same sequence as std::mt19937, but with a vectorised twist and block output
+class MersenneTwister
+{
+public:
+	typedef uint32_t result_type;
+
+	static const int N = 624;
+	static const int DEGREE = 19937;
+
+	// Jumped streams are spaced 2^64 outputs apart
+	static const int STREAM_SPACING_LOG2 = 64;
+
+	MersenneTwister(uint32_t seed = 5489u)
+	{
+		setSeed(seed);
+	}
+
+	static constexpr result_type min() { return 0u; }
+	static constexpr result_type max() { return 0xffffffffu; }
+
+	void setSeed(uint32_t seed)
+	{
+		m_state[0] = seed;
+		for (int i = 1; i < N; i++)
+		{
+			m_state[i] = 1812433253u * (m_state[i - 1] ^ (m_state[i - 1] >> 30)) + (uint32_t)i;
+		}
+		m_index = N;
+	}
+	// Fills the state with Philox words of seed and stream. Streams of any index
+	// cost the same few microseconds and overlap with odds of about 2^-19900.
+	void setStream(uint32_t seed, uint32_t stream);
+	// Seeds and jumps to the start of stream, provably apart from every other
+	// stream. Each set bit of stream costs a jump of a few milliseconds.
+	void setJumpedStream(uint32_t seed, uint32_t stream);
+	result_type operator()()
+	{
+		if (m_index >= N)
+		{
+			NoiseKernels::mersenneTwist(m_state);
+			m_index = 0;
+		}
+
+		return NoiseKernels::temper(m_state[m_index++]);
+	}
+	void processUniform(float* out, int numSamples, float gain)
+	{
+		while (numSamples > 0)
+		{
+			if (m_index >= N)
+			{
+				NoiseKernels::mersenneTwist(m_state);
+				m_index = 0;
+			}
+
+			const int count = numSamples < N - m_index ? numSamples : N - m_index;
+			NoiseKernels::mersenneUniform(m_state + m_index, out, count, gain);
+
+			m_index += count;
+			out += count;
+			numSamples -= count;
+		}
+	}
+	void processSign(float* out, int numSamples, float gain)
+	{
+		while (numSamples > 0)
+		{
+			if (m_index >= N)
+			{
+				NoiseKernels::mersenneTwist(m_state);
+				m_index = 0;
+			}
+
+			const int count = numSamples < N - m_index ? numSamples : N - m_index;
+			NoiseKernels::mersenneSign(m_state + m_index, out, count, gain);
+
+			m_index += count;
+			out += count;
+			numSamples -= count;
+		}
+	}
+	void processBits(uint32_t* out, int numSamples)
+	{
+		while (numSamples > 0)
+		{
+			if (m_index >= N)
+			{
+				NoiseKernels::mersenneTwist(m_state);
+				m_index = 0;
+			}
+
+			const int count = numSamples < N - m_index ? numSamples : N - m_index;
+			NoiseKernels::mersenneTemper(m_state + m_index, out, count);
+
+			m_index += count;
+			out += count;
+			numSamples -= count;
+		}
+	}
+
+private:
+	void jump(const uint32_t* polynomial);
+
+	uint32_t m_state[N];
+	int m_index = N;
+};
+
+//==============================================================================
+// Counter based generator, word n of a key is a pure function of n, so output
+// can start anywhere without generating what comes before it
+class Philox
+{
+public:
+	Philox(uint32_t seed = 0, uint32_t stream = 0)
+	{
+		setKey(seed, stream);
+	}
+
+	void setKey(uint32_t seed, uint32_t stream)
+	{
+		m_key[0] = seed;
+		m_key[1] = stream;
+	}
+	const uint32_t* getKey() const
+	{
+		return m_key;
+	}
+
+	// Words position to position + numWords - 1
+	void processBits(uint64_t position, uint32_t* out, int numWords) const;
+
+private:
+	uint32_t m_key[2];
+};
+
+// Engine for the rare samples that need more than one word, every sample of a key
+// gets its own sequence, apart from the words Philox::processBits hands out
+class PhiloxEngine
+{
+public:
+	typedef uint32_t result_type;
+
+	PhiloxEngine(const uint32_t* key, uint64_t sample) : m_key(key)
+	{
+		m_counter[0] = (uint32_t)sample;
+		m_counter[1] = (uint32_t)(sample >> 32);
+		m_counter[2] = 0u;
+		m_counter[3] = 0u;
+	}
+
+	static constexpr result_type min() { return 0u; }
+	static constexpr result_type max() { return 0xffffffffu; }
+
+	result_type operator()()
+	{
+		if (m_index >= 4)
+		{
+			m_counter[2]++;
+			NoiseKernels::philoxBlock(m_key, m_counter, m_words);
+			m_index = 0;
+		}
+
+		return m_words[m_index++];
+	}
+
+private:
+	const uint32_t* m_key;
+	uint32_t m_counter[4];
+	uint32_t m_words[4] = {};
+	int m_index = 4;
+};
+
+//==============================================================================
+// Small state engines, each instance owns its state so nothing is shared between
+// channels or instances. All of them are UniformRandomBitGenerators of 32 bit
+// words and are seeded per stream with setStream(seed, stream).
+class SplitMix64Engine
+{
+public:
+	typedef uint32_t result_type;
+
+	SplitMix64Engine(uint64_t state = 0) : m_state(state) {};
+
+	static constexpr result_type min() { return 0u; }
+	static constexpr result_type max() { return 0xffffffffu; }
+
+	void setStream(uint32_t seed, uint32_t stream)
+	{
+		m_state = ((uint64_t)seed << 32) | stream;
+	}
+	// Full 64 bit output, also used to seed the engines below
+	uint64_t next64()
+	{
+		uint64_t z = (m_state += 0x9e3779b97f4a7c15ull);
+		z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+		z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+		return z ^ (z >> 31);
+	}
+	result_type operator()()
+	{
+		return (result_type)(next64() >> 32);
+	}
+
+private:
+	uint64_t m_state;
+};
+
+// PCG XSH RR 64/32, the stream selects the increment, so streams are distinct sequences
+class Pcg32Engine
+{
+public:
+	typedef uint32_t result_type;
+
+	Pcg32Engine() {};
+
+	static constexpr result_type min() { return 0u; }
+	static constexpr result_type max() { return 0xffffffffu; }
+
+	void setStream(uint32_t seed, uint32_t stream)
+	{
+		m_state = 0u;
+		m_increment = ((uint64_t)stream << 1) | 1u;
+		(*this)();
+		m_state += SplitMix64Engine(seed).next64();
+		(*this)();
+	}
+	result_type operator()()
+	{
+		const uint64_t state = m_state;
+		m_state = state * 6364136223846793005ull + m_increment;
+
+		const uint32_t xorShifted = (uint32_t)(((state >> 18) ^ state) >> 27);
+		const uint32_t rotation = (uint32_t)(state >> 59);
+		return (xorShifted >> rotation) | (xorShifted << ((0u - rotation) & 31u));
+	}
+
+private:
+	uint64_t m_state = 0x853c49e6748fea9bull;
+	uint64_t m_increment = 0xda3e39cb94b95bdbull;
+};
+
+// xoshiro128+, the low bits are weaker than the high ones
+class Xoshiro128PlusEngine
+{
+public:
+	typedef uint32_t result_type;
+
+	Xoshiro128PlusEngine() {};
+
+	static constexpr result_type min() { return 0u; }
+	static constexpr result_type max() { return 0xffffffffu; }
+
+	void setStream(uint32_t seed, uint32_t stream)
+	{
+		SplitMix64Engine mix;
+		mix.setStream(seed, stream);
+
+		const uint64_t a = mix.next64();
+		const uint64_t b = mix.next64();
+		m_state[0] = (uint32_t)a;
+		m_state[1] = (uint32_t)(a >> 32);
+		m_state[2] = (uint32_t)b;
+		m_state[3] = (uint32_t)(b >> 32) | 1u;
+	}
+	result_type operator()()
+	{
+		const uint32_t result = m_state[0] + m_state[3];
+		const uint32_t t = m_state[1] << 9;
+
+		m_state[2] ^= m_state[0];
+		m_state[3] ^= m_state[1];
+		m_state[1] ^= m_state[2];
+		m_state[0] ^= m_state[3];
+		m_state[2] ^= t;
+		m_state[3] = (m_state[3] << 11) | (m_state[3] >> 21);
+
+		return result;
+	}
+
+private:
+	uint32_t m_state[4] = { 0x9e3779b9u, 0x243f6a88u, 0xb7e15162u, 0x6a09e667u };
+};
+
+// xoshiro256+, the high half of each 64 bit output
+class Xoshiro256PlusEngine
+{
+public:
+	typedef uint32_t result_type;
+
+	Xoshiro256PlusEngine() {};
+
+	static constexpr result_type min() { return 0u; }
+	static constexpr result_type max() { return 0xffffffffu; }
+
+	void setStream(uint32_t seed, uint32_t stream)
+	{
+		SplitMix64Engine mix;
+		mix.setStream(seed, stream);
+
+		for (auto& word : m_state)
+		{
+			word = mix.next64();
+		}
+		m_state[3] |= 1u;
+	}
+	result_type operator()()
+	{
+		const uint64_t result = m_state[0] + m_state[3];
+		const uint64_t t = m_state[1] << 17;
+
+		m_state[2] ^= m_state[0];
+		m_state[3] ^= m_state[1];
+		m_state[1] ^= m_state[2];
+		m_state[0] ^= m_state[3];
+		m_state[2] ^= t;
+		m_state[3] = (m_state[3] << 45) | (m_state[3] >> 19);
+
+		return (result_type)(result >> 32);
+	}
+
+private:
+	uint64_t m_state[4] = { 0x9e3779b97f4a7c15ull, 0x243f6a8885a308d3ull, 0xb7e151628aed2a6bull, 0x6a09e667f3bcc909ull };
+};
+
+// Small fast chaotic generator, the counter guarantees a period of at least 2^32
+class Sfc32Engine
+{
+public:
+	typedef uint32_t result_type;
+
+	Sfc32Engine() {};
+
+	static constexpr result_type min() { return 0u; }
+	static constexpr result_type max() { return 0xffffffffu; }
+
+	void setStream(uint32_t seed, uint32_t stream)
+	{
+		SplitMix64Engine mix;
+		mix.setStream(seed, stream);
+
+		const uint64_t a = mix.next64();
+		m_a = (uint32_t)a;
+		m_b = (uint32_t)(a >> 32);
+		m_c = (uint32_t)mix.next64();
+		m_counter = 1u;
+
+		// Mixes the seed into all of the state
+		for (int i = 0; i < 12; i++)
+		{
+			(*this)();
+		}
+	}
+	result_type operator()()
+	{
+		const uint32_t result = m_a + m_b + m_counter++;
+
+		m_a = m_b ^ (m_b >> 9);
+		m_b = m_c + (m_c << 3);
+		m_c = ((m_c << 21) | (m_c >> 11)) + result;
+
+		return result;
+	}
+
+private:
+	uint32_t m_a = 0u;
+	uint32_t m_b = 0x243f6a88u;
+	uint32_t m_c = 0xb7e15162u;
+	uint32_t m_counter = 1u;
+};
+
+//==============================================================================
+// Own PCG32 state instead of rand(), which is global and locks in some C libraries
 class RandomNoiseGenerator
 {
 public:
 	RandomNoiseGenerator() {};
 
+	void setStream(uint32_t seed, uint32_t stream)
+	{
+		m_engine.setStream(seed, stream);
+	};
 	float process()
 	{
-		return (2.0f * rand() / RAND_MAX) - 1.0f;
+		return NoiseKernels::bitsToFloat(m_engine());
+	};
+	void processBlock(float* out, int numSamples, float gain)
+	{
+		for (int i = 0; i < numSamples; i++)
+		{
+			out[i] = gain * process();
+		}
 	};
+
+private:
+	Pcg32Engine m_engine;
 };
 
 //==============================================================================
@@ -32,6 +539,29 @@ class FastNoiseGenerator
 public:
 	FastNoiseGenerator() {};
 
+	typedef uint32_t result_type;
+
+	static constexpr result_type min() { return 0u; }
+	static constexpr result_type max() { return 0xffffffffu; }
+
+	void setStream(uint32_t seed, uint32_t stream)
+	{
+		SplitMix64Engine mix;
+		mix.setStream(seed, stream);
+
+		const uint64_t state = mix.next64();
+		m_x1 = (int)(uint32_t)state;
+		m_x2 = (int)((uint32_t)(state >> 32) | 1u);
+	}
+	// Same sequence as process(), as words
+	result_type operator()()
+	{
+		const uint32_t x2 = (uint32_t)m_x2;
+		const uint32_t x1 = (uint32_t)m_x1 ^ x2;
+		m_x1 = (int)x1;
+		m_x2 = (int)(x2 + x1);
+		return x2;
+	}
 	float process()
 	{
 		m_x1 ^= m_x2;
@@ -39,10 +569,18 @@ public:
 		m_x2 += m_x1;
 		return out;
 	};
+	// Runs interleaved lanes, so this is a different stream than process()
+	void processBlock(float* out, int numSamples, float gain)
+	{
+		NoiseKernels::fastNoise(m_laneX1, m_laneX2, out, numSamples, gain);
+	};
 
 private:
 	int m_x1 = 0x67452301;
 	int m_x2 = 0xefcdab89;
+
+	uint32_t m_laneX1[NoiseKernels::LANES] = { 0x67452301u, 0x8b5f2a1cu, 0x2c9e47d3u, 0xd4a1f068u, 0x5f3b9ce2u, 0xa7c2184bu, 0x1e6d5b97u, 0xf0397a45u };
+	uint32_t m_laneX2[NoiseKernels::LANES] = { 0xefcdab89u, 0x3a7e91c5u, 0xc6180f3bu, 0x71d4e2a9u, 0x9b05c67eu, 0x48fa3d12u, 0xe2b7548cu, 0x0d61a9f7u };
 };
 
 //==============================================================================
@@ -85,6 +623,13 @@ public:
 
 		return out;
 	};
+	void processBlock(float* out, int numSamples, float gain)
+	{
+		for (int i = 0; i < numSamples; i++)
+		{
+			out[i] = gain * process();
+		}
+	};
 
 private:
 	int m_seed = 0;
@@ -97,11 +642,42 @@ class LehmerNoiseGenerator
 public:
 	LehmerNoiseGenerator() {};
 
+	typedef uint32_t result_type;
+
+	static constexpr result_type min() { return 0u; }
+	static constexpr result_type max() { return 0xffffffffu; }
+
+	// Odd states only, even ones fall into shorter cycles
+	void setStream(uint32_t seed, uint32_t stream)
+	{
+		SplitMix64Engine mix;
+		mix.setStream(seed, stream);
+		m_outLast = (long int)(((uint32_t)mix() & (uint32_t)(m_m - 1)) | 1u);
+	}
+	// Two steps per word, the top 16 of the 24 state bits of each
+	result_type operator()()
+	{
+		const uint32_t mask = (uint32_t)(m_m - 1);
+		const uint32_t first = ((uint32_t)m_a * (uint32_t)m_outLast) & mask;
+		const uint32_t second = ((uint32_t)m_a * first) & mask;
+		m_outLast = (long int)second;
+		return ((first >> 8) << 16) | (second >> 8);
+	}
+
 	float process()
 	{
 		m_outLast = (m_a * m_outLast) % m_m ;
 		return (2.0f * (float)m_outLast / (float)(m_m)) - 1.0f;
 	};
+	// Same sequence as process()
+	void processBlock(float* out, int numSamples, float gain)
+	{
+		m_outLast = (long int)NoiseKernels::lehmer((uint32_t)m_outLast, (uint32_t)m_a, (uint32_t)m_m, out, numSamples, gain);
+	};
+	void discard(unsigned long long steps)
+	{
+		m_outLast = (long int)(NoiseKernels::affineJump((uint32_t)m_outLast, (uint32_t)m_a, 0u, steps) & (uint32_t)(m_m - 1));
+	};
 
 private:
 	long int m_a = 5;
@@ -115,16 +691,44 @@ class LinearCongruentialNoiseGenerator
 public:
 	LinearCongruentialNoiseGenerator() {};
 
+	typedef uint32_t result_type;
+
+	static constexpr result_type min() { return 0u; }
+	static constexpr result_type max() { return 0xffffffffu; }
+
 	void setSeed(long seed)
 	{
 		m_outLast = seed;
 	}
+	void setStream(uint32_t seed, uint32_t stream)
+	{
+		SplitMix64Engine mix;
+		mix.setStream(seed, stream);
+		m_outLast = (long)mix();
+	}
+	// Two steps per word, the low half of the state has short periods
+	result_type operator()()
+	{
+		const uint32_t first = (uint32_t)m_a * (uint32_t)m_outLast + (uint32_t)m_c;
+		const uint32_t second = (uint32_t)m_a * first + (uint32_t)m_c;
+		m_outLast = (long)second;
+		return (first & 0xffff0000u) | (second >> 16);
+	}
 	float process()
 	{
 		m_outLast = m_a * m_outLast + m_c;
 		
 		return (2.0f * (float)((m_outLast >> 16) & 0x7fff) / 0x7fff) - 1.0f;
 	};
+	// Same sequence as process(), the output only depends on the low 32 bits of the state
+	void processBlock(float* out, int numSamples, float gain)
+	{
+		m_outLast = (long)NoiseKernels::linearCongruential((uint32_t)m_outLast, (uint32_t)m_a, (uint32_t)m_c, out, numSamples, gain);
+	};
+	void discard(unsigned long long steps)
+	{
+		m_outLast = (long)NoiseKernels::affineJump((uint32_t)m_outLast, (uint32_t)m_a, (uint32_t)m_c, steps);
+	};
 
 private:
 	long m_m = 65537L;
@@ -139,11 +743,39 @@ class LaggedFibonacciNoiseGenerator
 public:
 	LaggedFibonacciNoiseGenerator() {};
 
+	typedef uint32_t result_type;
+
+	static constexpr result_type min() { return 0u; }
+	static constexpr result_type max() { return 0xffffffffu; }
+
+	void setStream(uint32_t seed, uint32_t stream)
+	{
+		SplitMix64Engine mix;
+		mix.setStream(seed, stream);
+		engine.seed(mix());
+	}
+	// Two 24 bit outputs per word, the top 16 bits of each
+	result_type operator()()
+	{
+		const uint32_t first = engine();
+		const uint32_t second = engine();
+		return ((first >> 8) << 16) | (second >> 8);
+	}
+
 	float process()
 	{
 		int out = engine();
 		return (2.0f * (float)(out) / 16777216.0f) - 1.0f;
 	};
+	void processBlock(float* out, int numSamples, float gain)
+	{
+		const float scale = gain * (2.0f / 16777216.0f);
+
+		for (int i = 0; i < numSamples; i++)
+		{
+			out[i] = scale * (float)engine() - gain;
+		}
+	};
 
 private:
 	std::subtract_with_carry_engine<unsigned int, 24, 24, 55> engine;
@@ -157,67 +789,996 @@ public:
 
 	float process()
 	{
-		bool out = distribution(generator);
-		return (2.0f * (float)out) - 1.0f;
+		return distribution(generator);
+	};
+	void processBlock(float* out, int numSamples, float gain)
+	{
+		generator.processUniform(out, numSamples, gain);
+	};
+	void setStream(uint32_t seed, uint32_t stream)
+	{
+		generator.setStream(seed, stream);
 	};
 
 private:
-	std::mt19937 generator{ 123 };
+	MersenneTwister generator{ 123 };
 	std::uniform_real_distribution<float> distribution{ -1.0, 1.0 };
 };
 
 //==============================================================================
-class WhiteNoiseGenerator
+// Word source under the WhiteNoiseGenerator distributions. The engine is chosen
+// at runtime and resolved once per block, every engine keeps its own state, so
+// switching back and forth resumes each sequence where it was. Mersenne Twister
+// lives in WhiteNoiseGenerator itself, with its vectorised kernels.
+class NoiseEngine
 {
 public:
-	WhiteNoiseGenerator() {};
+	typedef uint32_t result_type;
 
-	enum DistributionType
+	NoiseEngine() {};
+
+	// Roughly from best quality to fewest cycles, the legacy generators last
+	enum Type
 	{
-		Uniform,
-		Normal,
+		MersenneTwister,
+		Pcg32,
+		Xoshiro256Plus,
+		Xoshiro128Plus,
+		Sfc32,
+		SplitMix64,
+		FastNoise,
+		LinearCongruential,
+		Lehmer,
+		LaggedFibonacci
+	};
+
+	static constexpr result_type min() { return 0u; }
+	static constexpr result_type max() { return 0xffffffffu; }
+
+	void setType(Type type)
+	{
+		m_type = type;
+	}
+	Type getType() const
+	{
+		return m_type;
+	}
+
+	void setStream(uint32_t seed, uint32_t stream)
+	{
+		m_pcg32.setStream(seed, stream);
+		m_xoshiro256Plus.setStream(seed, stream);
+		m_xoshiro128Plus.setStream(seed, stream);
+		m_sfc32.setStream(seed, stream);
+		m_splitMix64.setStream(seed, stream);
+		m_fastNoise.setStream(seed, stream);
+		m_linearCongruential.setStream(seed, stream);
+		m_lehmer.setStream(seed, stream);
+		m_laggedFibonacci.setStream(seed, stream);
+	}
+
+	// Single words for the rare samples that need more than one
+	result_type operator()()
+	{
+		switch (m_type)
+		{
+		case Type::Pcg32:				return m_pcg32();
+		case Type::Xoshiro256Plus:		return m_xoshiro256Plus();
+		case Type::Xoshiro128Plus:		return m_xoshiro128Plus();
+		case Type::Sfc32:				return m_sfc32();
+		case Type::SplitMix64:			return m_splitMix64();
+		case Type::FastNoise:			return m_fastNoise();
+		case Type::LinearCongruential:	return m_linearCongruential();
+		case Type::Lehmer:				return m_lehmer();
+		default:						return m_laggedFibonacci();
+		}
+	}
+	void processBits(uint32_t* out, int numWords)
+	{
+		switch (m_type)
+		{
+		case Type::Pcg32:				fill(m_pcg32, out, numWords); break;
+		case Type::Xoshiro256Plus:		fill(m_xoshiro256Plus, out, numWords); break;
+		case Type::Xoshiro128Plus:		fill(m_xoshiro128Plus, out, numWords); break;
+		case Type::Sfc32:				fill(m_sfc32, out, numWords); break;
+		case Type::SplitMix64:			fill(m_splitMix64, out, numWords); break;
+		case Type::FastNoise:			fill(m_fastNoise, out, numWords); break;
+		case Type::LinearCongruential:	fill(m_linearCongruential, out, numWords); break;
+		case Type::Lehmer:				fill(m_lehmer, out, numWords); break;
+		default:						fill(m_laggedFibonacci, out, numWords); break;
+		}
+	}
+
+private:
+	// Works on a local copy, state words could alias out and would be reloaded every word
+	template <typename Engine>
+	static void fill(Engine& engine, uint32_t* out, int numWords)
+	{
+		Engine local = engine;
+
+		for (int i = 0; i < numWords; i++)
+		{
+			out[i] = local();
+		}
+
+		engine = local;
+	}
+
+	Type m_type = Type::MersenneTwister;
+
+	Pcg32Engine m_pcg32;
+	Xoshiro256PlusEngine m_xoshiro256Plus;
+	Xoshiro128PlusEngine m_xoshiro128Plus;
+	Sfc32Engine m_sfc32;
+	SplitMix64Engine m_splitMix64;
+	FastNoiseGenerator m_fastNoise;
+	LinearCongruentialNoiseGenerator m_linearCongruential;
+	LehmerNoiseGenerator m_lehmer;
+	LaggedFibonacciNoiseGenerator m_laggedFibonacci;
+};
+
+//==============================================================================
+// Compile time math for the lookup tables below
+namespace NoiseMath
+{
+	constexpr double constExp(double x)
+	{
+		// exp(x) = exp(x / 16)^16
+		const double y = x / 16.0;
+		double term = 1.0;
+		double sum = 1.0;
+		for (int n = 1; n < 18; n++)
+		{
+			term *= y / n;
+			sum += term;
+		}
+		for (int n = 0; n < 4; n++)
+		{
+			sum *= sum;
+		}
+		return sum;
+	}
+
+	constexpr double constLog(double x)
+	{
+		const double ln2 = 0.69314718055994530942;
+
+		int exponent = 0;
+		while (x > 2.0)
+		{
+			x *= 0.5;
+			exponent++;
+		}
+		while (x < 0.5)
+		{
+			x *= 2.0;
+			exponent--;
+		}
+
+		// log(x) = 2 atanh((x - 1) / (x + 1))
+		const double z = (x - 1.0) / (x + 1.0);
+		double power = z;
+		double sum = 0.0;
+		for (int n = 0; n < 20; n++)
+		{
+			sum += power / (2 * n + 1);
+			power *= z * z;
+		}
+		return 2.0 * sum + exponent * ln2;
+	}
+
+	constexpr double constSqrt(double x)
+	{
+		double y = x > 1.0 ? x : 1.0;
+		for (int n = 0; n < 64; n++)
+		{
+			const double next = 0.5 * (y + x / y);
+			if (next == y)
+				break;
+			y = next;
+		}
+		return y;
+	}
+}
+
+//==============================================================================
+// Marsaglia & Tsang ziggurat with 128 layers, tables are built at compile time
+struct ZigguratTables
+{
+	static constexpr int LAYERS = 128;
+	static constexpr double R = 3.442619855899;
+	static constexpr double AREA = 9.91256303526217e-3;
+
+	uint32_t k[LAYERS] = {};
+	float w[LAYERS] = {};
+	float f[LAYERS] = {};
+
+	constexpr ZigguratTables()
+	{
+		const double m1 = 2147483648.0;
+
+		double dn = R;
+		double tn = dn;
+		const double q = AREA / NoiseMath::constExp(-0.5 * dn * dn);
+
+		k[0] = (uint32_t)((dn / q) * m1);
+		k[1] = 0;
+		w[0] = (float)(q / m1);
+		w[LAYERS - 1] = (float)(dn / m1);
+		f[0] = 1.0f;
+		f[LAYERS - 1] = (float)NoiseMath::constExp(-0.5 * dn * dn);
+
+		for (int i = LAYERS - 2; i >= 1; i--)
+		{
+			dn = NoiseMath::constSqrt(-2.0 * NoiseMath::constLog(AREA / dn + NoiseMath::constExp(-0.5 * dn * dn)));
+			k[i + 1] = (uint32_t)((dn / tn) * m1);
+			tn = dn;
+			f[i] = (float)NoiseMath::constExp(-0.5 * dn * dn);
+			w[i] = (float)(dn / m1);
+		}
+	}
+};
+
+class NormalDistribution
+{
+public:
+	NormalDistribution(float mean, float standardDeviation) : m_mean(mean), m_standardDeviation(standardDeviation) {};
+
+	template <typename Engine>
+	float operator()(Engine& engine)
+	{
+		return m_mean + m_standardDeviation * standard(engine);
+	}
+	template <typename Engine>
+	void processBlock(Engine& engine, float* out, int numSamples, float gain)
+	{
+		const float scale = gain * m_standardDeviation;
+		const float offset = gain * m_mean;
+
+		for (int i = 0; i < numSamples; i++)
+		{
+			out[i] = scale * standard(engine) + offset;
+		}
+	}
+	// Tempers a chunk of words at once, only the rare wedge and tail samples call back into the engine
+	void processBlock(MersenneTwister& engine, float* out, int numSamples, float gain)
+	{
+		processWords(engine, out, numSamples, gain);
+	}
+	void processBlock(MersenneTwister& engine, double* out, int numSamples, float gain)
+	{
+		processWords(engine, out, numSamples, gain);
+	}
+	// One word per sample, getEngine(i) supplies the engine for sample i when it needs more.
+	// Double output keeps the 25 bits of the rectangle position.
+	template <typename SampleType, typename GetEngine>
+	void processBits(const uint32_t* bits, SampleType* out, int numSamples, float gain, GetEngine getEngine)
+	{
+		const SampleType scale = (SampleType)(gain * m_standardDeviation);
+		const SampleType offset = (SampleType)(gain * m_mean);
+
+		for (int i = 0; i < numSamples; i++)
+		{
+			const int layer = (int)(bits[i] & (ZigguratTables::LAYERS - 1));
+			const int32_t position = (int32_t)(bits[i] & ~(uint32_t)(ZigguratTables::LAYERS - 1));
+			const uint32_t magnitude = position < 0 ? 0u - (uint32_t)position : (uint32_t)position;
+
+			if (magnitude < tables.k[layer])
+			{
+				out[i] = scale * ((SampleType)position * (SampleType)tables.w[layer]) + offset;
+			}
+			else
+			{
+				auto&& engine = getEngine(i);
+				out[i] = scale * (SampleType)standardSlow(engine, layer, position) + offset;
+			}
+		}
+	}
+
+private:
+	template <typename SampleType>
+	void processWords(MersenneTwister& engine, SampleType* out, int numSamples, float gain)
+	{
+		uint32_t bits[BITS_CHUNK];
+
+		while (numSamples > 0)
+		{
+			const int count = numSamples < BITS_CHUNK ? numSamples : BITS_CHUNK;
+			engine.processBits(bits, count);
+			processBits(bits, out, count, gain, [&engine](int) -> MersenneTwister& { return engine; });
+
+			out += count;
+			numSamples -= count;
+		}
+	}
+
+	static constexpr ZigguratTables tables{};
+	static const int BITS_CHUNK = 256;
+
+	template <typename Engine>
+	static float uniform(Engine& engine)
+	{
+		// (0, 1], safe for log()
+		return ((float)(engine() >> 8) + 1.0f) * (1.0f / 16777216.0f);
+	}
+
+	template <typename Engine>
+	static float standard(Engine& engine)
+	{
+		// Low 7 bits pick the layer, the rest is the signed position in it
+		const uint32_t bits = engine();
+		const int layer = (int)(bits & (ZigguratTables::LAYERS - 1));
+		const int32_t position = (int32_t)(bits & ~(uint32_t)(ZigguratTables::LAYERS - 1));
+		const uint32_t magnitude = position < 0 ? 0u - (uint32_t)position : (uint32_t)position;
+
+		// Inside the rectangle, around 99% of the time
+		if (magnitude < tables.k[layer])
+			return (float)position * tables.w[layer];
+
+		return standardSlow(engine, layer, position);
+	}
+
+	template <typename Engine>
+	static float standardSlow(Engine& engine, int layer, int32_t position)
+	{
+		for (;;)
+		{
+			const float x = (float)position * tables.w[layer];
+
+			if (layer == 0)
+			{
+				// Tail beyond R
+				const float r = (float)ZigguratTables::R;
+				float tailX = 0.0f;
+				float tailY = 0.0f;
+				do
+				{
+					tailX = -logf(uniform(engine)) / r;
+					tailY = -logf(uniform(engine));
+				} while (tailY + tailY < tailX * tailX);
+
+				return position > 0 ? r + tailX : -r - tailX;
+			}
+
+			// Wedge
+			if (tables.f[layer] + uniform(engine) * (tables.f[layer - 1] - tables.f[layer]) < expf(-0.5f * x * x))
+				return x;
+
+			const uint32_t bits = engine();
+			layer = (int)(bits & (ZigguratTables::LAYERS - 1));
+			position = (int32_t)(bits & ~(uint32_t)(ZigguratTables::LAYERS - 1));
+			const uint32_t magnitude = position < 0 ? 0u - (uint32_t)position : (uint32_t)position;
+
+			if (magnitude < tables.k[layer])
+				return (float)position * tables.w[layer];
+		}
+	}
+
+	float m_mean = 0.0f;
+	float m_standardDeviation = 1.0f;
+};
+
+//==============================================================================
+// Walker alias table for an amplitude PDF given as weights of equal width bins
+// over [-1, 1). One word per sample, the high half of word * bins picks the bin,
+// the low half decides between it and its alias and is still uniform within
+// either outcome, so it also places the sample inside the bin.
+class AliasTable
+{
+public:
+	AliasTable() {};
+
+	static const int MAX_BINS = 1024;
+
+	// Weights need not be normalised. Allocates, not for the audio thread.
+	void build(const float* weights, int numBins);
+
+	// Shape of the former PieceWise mode, 1 : 30 : 1 over [-1, -0.1), [-0.1, 0.1), [0.1, 1)
+	static const AliasTable& getDefault();
+
+	int getNumBins() const
+	{
+		return m_numBins;
+	}
+	const std::vector<float>& getWeights() const
+	{
+		return m_weights;
+	}
+
+	float sample(uint32_t bits) const
+	{
+		return NoiseKernels::aliasSample(m_entries.data(), (uint32_t)m_numBins, bits);
+	}
+	void process(const uint32_t* bits, float* out, int numSamples, float gain) const
+	{
+		NoiseKernels::aliasSample(m_entries.data(), (uint32_t)m_numBins, bits, out, numSamples, gain);
+	}
+
+private:
+	int m_numBins = 0;
+	std::vector<float> m_weights;
+	std::vector<NoiseKernels::AliasEntry> m_entries;
+};
+
+// Passes tables from the message thread to the audio thread without locks.
+// The audio thread takes the newest table at the start of a block and hands the
+// one it replaced back, the message thread frees it on the next submit.
+template <typename Table>
+class TableSwap
+{
+public:
+	TableSwap() {};
+	~TableSwap()
+	{
+		delete m_pending.exchange(nullptr);
+		delete m_retired.exchange(nullptr);
+		delete m_current;
+	}
+
+	// Message thread
+	void submit(std::unique_ptr<Table> table)
+	{
+		delete m_retired.exchange(nullptr, std::memory_order_acquire);
+		delete m_pending.exchange(table.release(), std::memory_order_acq_rel);
+	}
+
+	// Audio thread, nullptr until the first submit
+	const Table* acquire()
+	{
+		// A table is only taken once the previous one has been collected
+		if (m_retired.load(std::memory_order_relaxed) == nullptr)
+		{
+			if (Table* pending = m_pending.exchange(nullptr, std::memory_order_acq_rel))
+			{
+				m_retired.store(m_current, std::memory_order_release);
+				m_current = pending;
+			}
+		}
+
+		return m_current;
+	}
+
+private:
+	std::atomic<Table*> m_pending{ nullptr };
+	std::atomic<Table*> m_retired{ nullptr };
+	Table* m_current = nullptr;
+};
+
+using AliasTableSwap = TableSwap<AliasTable>;
+
+//==============================================================================
+class WhiteNoiseGenerator
+{
+public:
+	WhiteNoiseGenerator() {};
+
+	enum DistributionType
+	{
+		Uniform,
+		Normal,
 		Bernoulli,
-		PieceWise
+		PieceWise,
+		Velvet
+	};
+
+	// One impulse of velvet noise, position is relative to the block start
+	struct Impulse
+	{
+		int position;
+		float value;
 	};
 
+	// Velvet impulses are at least this many samples apart on average
+	static constexpr float MIN_VELVET_SPACING = 2.0f;
+	static constexpr double MAX_VELVET_SPACING = 1073741824.0;
+
 	void setDistributionType(DistributionType distributionType)
 	{
 		m_distributionType = distributionType;
+
+		// Picked once here instead of branching on every sample
+		switch (distributionType)
+		{
+		case DistributionType::Uniform:		m_process = &WhiteNoiseGenerator::process<DistributionType::Uniform>; break;
+		case DistributionType::Normal:		m_process = &WhiteNoiseGenerator::process<DistributionType::Normal>; break;
+		case DistributionType::Bernoulli:	m_process = &WhiteNoiseGenerator::process<DistributionType::Bernoulli>; break;
+		case DistributionType::PieceWise:	m_process = &WhiteNoiseGenerator::process<DistributionType::PieceWise>; break;
+		default:							m_process = &WhiteNoiseGenerator::process<DistributionType::Velvet>; break;
+		}
+	}
+	DistributionType getDistributionType() const
+	{
+		return m_distributionType;
+	}
+	// Level trim in dB that brings each distribution to the same loudness
+	static float getLevelTrim(DistributionType distributionType)
+	{
+		switch (distributionType)
+		{
+		case DistributionType::Uniform:		return -42.0f;
+		case DistributionType::Normal:		return -43.0f;
+		case DistributionType::Bernoulli:	return -47.0f;
+		case DistributionType::PieceWise:	return -31.0f;
+		default:							return -33.0f;
+		}
+	}
+	// Streams of the same seed never overlap. The Mersenne Twister stream is
+	// jumped, so keep this for the rare explicit seed.
+	void setStream(uint32_t seed, uint32_t stream)
+	{
+		m_mersenneTwisterGenerator.setJumpedStream(seed, stream);
+		m_engine.setStream(seed, stream);
+	}
+	// Consecutive streams for count generators, one per channel and instance.
+	// Mersenne Twister streams are keyed on Philox, so no jump is needed.
+	static void setStreams(WhiteNoiseGenerator* generators, int count, uint32_t seed, uint32_t firstStream)
+	{
+		for (int i = 0; i < count; i++)
+		{
+			generators[i].m_mersenneTwisterGenerator.setStream(seed, firstStream + (uint32_t)i);
+			generators[i].m_engine.setStream(seed, firstStream + (uint32_t)i);
+		}
+	}
+
+	// Word source of the streaming paths, counter mode always runs on Philox
+	void setEngine(NoiseEngine::Type engine)
+	{
+		m_engine.setType(engine);
+	}
+	NoiseEngine::Type getEngine() const
+	{
+		return m_engine.getType();
+	}
+	float process()
+	{
+		return (this->*m_process)();
+	}
+	void processBlock(float* out, int numSamples, float gain)
+	{
+		switch (m_distributionType)
+		{
+		case DistributionType::Uniform:		processBlock<DistributionType::Uniform>(out, numSamples, gain); break;
+		case DistributionType::Normal:		processBlock<DistributionType::Normal>(out, numSamples, gain); break;
+		case DistributionType::Bernoulli:	processBlock<DistributionType::Bernoulli>(out, numSamples, gain); break;
+		case DistributionType::PieceWise:	processBlock<DistributionType::PieceWise>(out, numSamples, gain); break;
+		default:							processBlock<DistributionType::Velvet>(out, numSamples, gain); break;
+		}
+	}
+
+	// PieceWise samples this table, nullptr restores the default. The table has to
+	// outlive its use here.
+	void setAliasTable(const AliasTable* table)
+	{
+		m_aliasTable = table != nullptr ? table : &AliasTable::getDefault();
+	}
+
+	//==============================================================================
+	// Velvet noise, one impulse of random sign at a random position in every grid
+	// cell of 1 / density samples. Density is in impulses per sample.
+	void setVelvetDensity(float density)
+	{
+		const double spacing = density > 0.0f ? 1.0 / (double)density : (double)MIN_VELVET_SPACING;
+		const double clamped = spacing < (double)MIN_VELVET_SPACING ? (double)MIN_VELVET_SPACING : spacing > MAX_VELVET_SPACING ? MAX_VELVET_SPACING : spacing;
+		m_velvetSpacing = (uint64_t)(clamped * (double)VELVET_ONE);
+	}
+	// Upper bound of the impulses in numSamples
+	int getMaxImpulses(int numSamples) const
+	{
+		return (int)(((uint64_t)numSamples << 32) / m_velvetSpacing) + 2;
 	}
+	// Impulses of the next numSamples for sparse consumers, the same ones the
+	// Velvet block path writes. Impulses past maxImpulses are dropped.
+	int processImpulses(Impulse* impulses, int maxImpulses, int numSamples, float gain)
+	{
+		int count = 0;
+		processVelvet(numSamples, [impulses, maxImpulses, gain, &count](int position, float sign)
+		{
+			if (count < maxImpulses)
+				impulses[count++] = { position, sign * gain };
+		});
+		return count;
+	}
+
+	//==============================================================================
+	// One specialised loop per distribution, for callers that know it up front
+	template <DistributionType type>
 	float process()
 	{
-		if (m_distributionType == DistributionType::Uniform)
+		if constexpr (type != DistributionType::Velvet)
+		{
+			if (m_engine.getType() != NoiseEngine::Type::MersenneTwister)
+				return sample<type>(m_engine);
+			else
+				return sample<type>(m_mersenneTwisterGenerator);
+		}
+		else
+		{
+			float value = 0.0f;
+			processVelvet(1, [&value](int, float sign) { value = sign; });
+			return value;
+		}
+	}
+	// Counter mode, sample n of a channel only depends on seed, stream and n, so
+	// blocks can start at any position and seeking costs nothing
+	void setCounterKey(uint32_t seed, uint32_t stream)
+	{
+		m_counterGenerator.setKey(seed, stream);
+	}
+	void processBlockAt(uint64_t position, float* out, int numSamples, float gain)
+	{
+		switch (m_distributionType)
+		{
+		case DistributionType::Uniform:		processBlockAt<DistributionType::Uniform>(position, out, numSamples, gain); break;
+		case DistributionType::Normal:		processBlockAt<DistributionType::Normal>(position, out, numSamples, gain); break;
+		case DistributionType::Bernoulli:	processBlockAt<DistributionType::Bernoulli>(position, out, numSamples, gain); break;
+		case DistributionType::PieceWise:	processBlockAt<DistributionType::PieceWise>(position, out, numSamples, gain); break;
+		default:							processBlockAt<DistributionType::Velvet>(position, out, numSamples, gain); break;
+		}
+	}
+	template <DistributionType type>
+	void processBlockAt(uint64_t position, float* out, int numSamples, float gain)
+	{
+		if constexpr (type == DistributionType::Velvet)
+		{
+			processVelvetAt(position, out, numSamples, gain);
+			return;
+		}
+
+		uint32_t bits[COUNTER_CHUNK];
+
+		while (numSamples > 0)
+		{
+			const int count = numSamples < COUNTER_CHUNK ? numSamples : COUNTER_CHUNK;
+			m_counterGenerator.processBits(position, bits, count);
+
+			if constexpr (type == DistributionType::Uniform)
+			{
+				for (int i = 0; i < count; i++)
+				{
+					out[i] = gain * NoiseKernels::bitsToFloat(bits[i]);
+				}
+			}
+			else if constexpr (type == DistributionType::Normal)
+			{
+				const uint32_t* key = m_counterGenerator.getKey();
+				m_normalDistribution.processBits(bits, out, count, gain, [key, position](int i) { return PhiloxEngine(key, position + (uint64_t)i); });
+			}
+			else if constexpr (type == DistributionType::Bernoulli)
+			{
+				for (int i = 0; i < count; i++)
+				{
+					out[i] = (bits[i] & 0x80000000u) ? gain : -gain;
+				}
+			}
+			else if constexpr (type == DistributionType::PieceWise)
+			{
+				m_aliasTable->process(bits, out, count, gain);
+			}
+
+			position += (uint64_t)count;
+			out += count;
+			numSamples -= count;
+		}
+	}
+
+	template <DistributionType type>
+	void processBlock(float* out, int numSamples, float gain)
+	{
+		if constexpr (type != DistributionType::Velvet)
+		{
+			if (m_engine.getType() != NoiseEngine::Type::MersenneTwister)
+			{
+				processEngine<type>(out, numSamples, gain);
+				return;
+			}
+		}
+
+		if constexpr (type == DistributionType::Uniform)
 		{
-			return m_realDistribution(m_mersenneTwisterGenerator);
+			m_mersenneTwisterGenerator.processUniform(out, numSamples, gain);
 		}
-		else if (m_distributionType == DistributionType::Normal)
+		else if constexpr (type == DistributionType::Normal)
 		{
-			return m_normalDistribution(m_mersenneTwisterGenerator);
+			m_normalDistribution.processBlock(m_mersenneTwisterGenerator, out, numSamples, gain);
 		}
-		else if (m_distributionType == DistributionType::Bernoulli)
+		else if constexpr (type == DistributionType::Bernoulli)
 		{
-			return (2.0f * m_bernoulliDistribution(m_mersenneTwisterGenerator)) - 1.0f;
+			m_mersenneTwisterGenerator.processSign(out, numSamples, gain);
+		}
+		else if constexpr (type == DistributionType::PieceWise)
+		{
+			uint32_t bits[COUNTER_CHUNK];
+
+			while (numSamples > 0)
+			{
+				const int count = numSamples < COUNTER_CHUNK ? numSamples : COUNTER_CHUNK;
+				m_mersenneTwisterGenerator.processBits(bits, count);
+				m_aliasTable->process(bits, out, count, gain);
+
+				out += count;
+				numSamples -= count;
+			}
 		}
 		else
 		{
-			return m_pieceWiceDistribution(m_mersenneTwisterGenerator);
+			// Only the impulses are written
+			std::fill(out, out + numSamples, 0.0f);
+			processVelvet(numSamples, [out, gain](int position, float sign) { out[position] = sign * gain; });
+		}
+	}
+
+	//==============================================================================
+	// Double output from the same words as the float paths, so a stream sounds the
+	// same either way. Uniform keeps all 32 bits, Normal the full ziggurat
+	// position, PieceWise is widened from float.
+	template <DistributionType type>
+	void processBlockAt(uint64_t position, double* out, int numSamples, float gain)
+	{
+		uint32_t bits[COUNTER_CHUNK];
+		float block[COUNTER_CHUNK];
+
+		while (numSamples > 0)
+		{
+			const int count = numSamples < COUNTER_CHUNK ? numSamples : COUNTER_CHUNK;
+
+			if constexpr (type == DistributionType::Uniform || type == DistributionType::Bernoulli)
+			{
+				m_counterGenerator.processBits(position, bits, count);
+				bitsToSamples<type>(bits, out, count, gain);
+			}
+			else if constexpr (type == DistributionType::Normal)
+			{
+				m_counterGenerator.processBits(position, bits, count);
+
+				const uint32_t* key = m_counterGenerator.getKey();
+				m_normalDistribution.processBits(bits, out, count, gain, [key, position](int i) { return PhiloxEngine(key, position + (uint64_t)i); });
+			}
+			else
+			{
+				processBlockAt<type>(position, block, count, 1.0f);
+				widen(block, out, count, gain);
+			}
+
+			position += (uint64_t)count;
+			out += count;
+			numSamples -= count;
+		}
+	}
+
+	template <DistributionType type>
+	void processBlock(double* out, int numSamples, float gain)
+	{
+		if constexpr (type != DistributionType::Velvet)
+		{
+			if (m_engine.getType() != NoiseEngine::Type::MersenneTwister)
+			{
+				processEngine<type>(out, numSamples, gain);
+				return;
+			}
+		}
+
+		if constexpr (type == DistributionType::Normal)
+		{
+			m_normalDistribution.processBlock(m_mersenneTwisterGenerator, out, numSamples, gain);
+			return;
+		}
+		else if constexpr (type == DistributionType::Velvet)
+		{
+			std::fill(out, out + numSamples, 0.0);
+			processVelvet(numSamples, [out, gain](int position, float sign) { out[position] = (double)(sign * gain); });
+			return;
+		}
+
+		uint32_t bits[COUNTER_CHUNK];
+		float block[COUNTER_CHUNK];
+
+		while (numSamples > 0)
+		{
+			const int count = numSamples < COUNTER_CHUNK ? numSamples : COUNTER_CHUNK;
+
+			if constexpr (type == DistributionType::Uniform || type == DistributionType::Bernoulli)
+			{
+				m_mersenneTwisterGenerator.processBits(bits, count);
+				bitsToSamples<type>(bits, out, count, gain);
+			}
+			else
+			{
+				processBlock<type>(block, count, 1.0f);
+				widen(block, out, count, gain);
+			}
+
+			out += count;
+			numSamples -= count;
 		}
 	}
 
 private:
+	template <DistributionType type, typename Engine>
+	float sample(Engine& engine)
+	{
+		if constexpr (type == DistributionType::Uniform)
+			return m_realDistribution(engine);
+		else if constexpr (type == DistributionType::Normal)
+			return m_normalDistribution(engine);
+		else if constexpr (type == DistributionType::Bernoulli)
+			return (2.0f * m_bernoulliDistribution(engine)) - 1.0f;
+		else
+			return m_aliasTable->sample(engine());
+	}
+
+	// Every distribution but Velvet from the words of the selected engine
+	template <DistributionType type, typename SampleType>
+	void processEngine(SampleType* out, int numSamples, float gain)
+	{
+		uint32_t bits[COUNTER_CHUNK];
+		float block[COUNTER_CHUNK];
+
+		while (numSamples > 0)
+		{
+			const int count = numSamples < COUNTER_CHUNK ? numSamples : COUNTER_CHUNK;
+			m_engine.processBits(bits, count);
+
+			if constexpr (type == DistributionType::Uniform || type == DistributionType::Bernoulli)
+			{
+				bitsToSamples<type>(bits, out, count, gain);
+			}
+			else if constexpr (type == DistributionType::Normal)
+			{
+				m_normalDistribution.processBits(bits, out, count, gain, [this](int) -> NoiseEngine& { return m_engine; });
+			}
+			else if constexpr (std::is_same<SampleType, double>::value)
+			{
+				m_aliasTable->process(bits, block, count, 1.0f);
+				widen(block, out, count, gain);
+			}
+			else
+			{
+				m_aliasTable->process(bits, out, count, gain);
+			}
+
+			out += count;
+			numSamples -= count;
+		}
+	}
+
+	// Uniform and Bernoulli straight from words, matching the float kernels
+	template <DistributionType type>
+	static void bitsToSamples(const uint32_t* bits, float* out, int numSamples, float gain)
+	{
+		for (int i = 0; i < numSamples; i++)
+		{
+			if constexpr (type == DistributionType::Uniform)
+				out[i] = gain * NoiseKernels::bitsToFloat(bits[i]);
+			else
+				out[i] = gain * (float)((int32_t)((bits[i] >> 31) << 1) - 1);
+		}
+	}
+	template <DistributionType type>
+	static void bitsToSamples(const uint32_t* bits, double* out, int numSamples, float gain)
+	{
+		const double scale = (double)gain;
+
+		for (int i = 0; i < numSamples; i++)
+		{
+			// Branch free sign, the words are random so a branch would miss half the time
+			if constexpr (type == DistributionType::Uniform)
+				out[i] = scale * NoiseKernels::bitsToDouble(bits[i]);
+			else
+				out[i] = scale * (double)((int32_t)((bits[i] >> 31) << 1) - 1);
+		}
+	}
+	static void widen(const float* in, double* out, int numSamples, float gain)
+	{
+		const double scale = (double)gain;
+
+		for (int i = 0; i < numSamples; i++)
+		{
+			out[i] = scale * (double)in[i];
+		}
+	}
+
+	// Start of a velvet cell in whole samples and its fraction in 32.32, exact
+	// at any cell index as the product is split into 32 bit halves
+	static uint64_t getVelvetCellStart(uint64_t cell, uint64_t spacing, uint32_t* fraction)
+	{
+		const uint64_t cellHigh = cell >> 32;
+		const uint64_t cellLow = cell & 0xffffffffu;
+		if (fraction != nullptr)
+			*fraction = (uint32_t)(cell * spacing);
+		return cellHigh * spacing + cellLow * (spacing >> 32) + ((cellLow * (spacing & 0xffffffffu)) >> 32);
+	}
+	// Impulse of a cell, sign from the top bit and jitter from the rest, rounded
+	// so it never leaves the cell
+	static uint64_t getVelvetPosition(uint64_t cell, uint64_t spacing, uint32_t bits)
+	{
+		uint32_t fraction = 0;
+		const uint64_t start = getVelvetCellStart(cell, spacing, &fraction);
+
+		// (spacing - 1) * bits / 2^31 in 32.32
+		const uint64_t jitterBits = (uint64_t)(bits & 0x7fffffffu) << 1;
+		const uint64_t range = spacing - VELVET_ONE;
+		const uint64_t jitter = jitterBits * (range >> 32) + ((jitterBits * (range & 0xffffffffu)) >> 32);
+
+		return start + (((uint64_t)fraction + jitter + (VELVET_ONE >> 1)) >> 32);
+	}
+	void nextVelvetImpulse()
+	{
+		const uint32_t bits = m_engine.getType() != NoiseEngine::Type::MersenneTwister ? m_engine() : m_mersenneTwisterGenerator();
+		m_velvetNext = getVelvetPosition(m_velvetCell, m_velvetSpacing, bits);
+		m_velvetSign = (bits & 0x80000000u) ? 1.0f : -1.0f;
+		m_velvetCell++;
+	}
+	template <typename Consumer>
+	void processVelvet(int numSamples, Consumer&& consumer)
+	{
+		if (m_velvetSign == 0.0f)
+			nextVelvetImpulse();
+
+		const uint64_t end = m_velvetPosition + (uint64_t)numSamples;
+		while (m_velvetNext < end)
+		{
+			consumer((int)(m_velvetNext - m_velvetPosition), m_velvetSign);
+			nextVelvetImpulse();
+		}
+
+		m_velvetPosition = end;
+	}
+	// Counter mode, cell n takes Philox word n so any block can be rendered alone
+	void processVelvetAt(uint64_t position, float* out, int numSamples, float gain)
+	{
+		std::fill(out, out + numSamples, 0.0f);
+
+		const uint64_t end = position + (uint64_t)numSamples;
+
+		// Estimated in double, then settled on the cell holding position
+		uint64_t cell = (uint64_t)((double)position * (double)VELVET_ONE / (double)m_velvetSpacing);
+		while (cell > 0 && getVelvetCellStart(cell, m_velvetSpacing, nullptr) > position)
+			cell--;
+		while (getVelvetCellStart(cell + 1, m_velvetSpacing, nullptr) <= position)
+			cell++;
+
+		// The previous cell's impulse can round onto the first sample
+		cell = cell > 0 ? cell - 1 : 0;
+
+		for (; getVelvetCellStart(cell, m_velvetSpacing, nullptr) < end; cell++)
+		{
+			uint32_t bits;
+			m_counterGenerator.processBits(cell, &bits, 1);
+
+			const uint64_t impulse = getVelvetPosition(cell, m_velvetSpacing, bits);
+			if (impulse >= position && impulse < end)
+				out[impulse - position] = (bits & 0x80000000u) ? gain : -gain;
+		}
+	}
+
 	DistributionType m_distributionType = DistributionType::Uniform;
+	float (WhiteNoiseGenerator::*m_process)() = &WhiteNoiseGenerator::process<DistributionType::Uniform>;
+
+	static const int COUNTER_CHUNK = 256;
+
+	// 1.0 of the 32.32 velvet spacing
+	static const uint64_t VELVET_ONE = (uint64_t)1 << 32;
 
 	// Generators
-	std::mt19937 m_mersenneTwisterGenerator{ 123 };
+	MersenneTwister m_mersenneTwisterGenerator{ 123 };
+	NoiseEngine m_engine;
+	Philox m_counterGenerator;
 
 	// Distributions
 	std::uniform_real_distribution<float> m_realDistribution{ -1.0, 1.0 };
 
-	std::normal_distribution<float> m_normalDistribution{ 0.0f, 0.65f };
+	NormalDistribution m_normalDistribution{ 0.0f, 0.65f };
 
-	std::vector<double> i{ -1.0, -0.1, 0.1, 1.0};
-	std::vector<double> w{ 1, 30, 1 };
-	std::piecewise_constant_distribution<> m_pieceWiceDistribution{ i.begin(), i.end(), w.begin() };
+	// PieceWise amplitude PDF, owned elsewhere
+	const AliasTable* m_aliasTable = &AliasTable::getDefault();
 
 	std::bernoulli_distribution m_bernoulliDistribution{ 0.5 };
+
+	// Velvet grid with the spacing in 32.32, a sign of 0 means no impulse has
+	// been drawn yet
+	uint64_t m_velvetSpacing = (uint64_t)24 << 32;
+	uint64_t m_velvetCell = 0;
+	uint64_t m_velvetPosition = 0;
+	uint64_t m_velvetNext = 0;
+	float m_velvetSign = 0.0f;
 };
\ No newline at end of file
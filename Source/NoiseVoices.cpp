@@ -0,0 +1,275 @@
+/*
+  ==============================================================================
+
+    NoiseVoices.cpp
+    Created: 18 Oct 2026 6:48:19pm
+    Author:  zazz
+
+  ==============================================================================
+*/
+
+#include "NoiseVoices.h"
+
+static const double PI = 3.14159265358979323846;
+
+//==============================================================================
+void NoiseEnvelope::setParameters(const Parameters& parameters, double sampleRate)
+{
+	// Zero length stages take one sample
+	const auto step = [sampleRate](float seconds, float distance)
+	{
+		const double samples = seconds * sampleRate;
+		return (float)(samples > 1.0 ? distance / samples : distance);
+	};
+
+	m_sustain = parameters.sustain;
+	m_attackStep = step(parameters.attackSeconds, 1.0f);
+	m_decayStep = step(parameters.decaySeconds, 1.0f - m_sustain);
+	m_releaseStep = step(parameters.releaseSeconds, 1.0f);
+}
+
+void NoiseEnvelope::process(float* data, int numSamples)
+{
+	for (int i = 0; i < numSamples; i++)
+	{
+		switch (m_stage)
+		{
+		case Stage::Attack:
+			m_level += m_attackStep;
+			if (m_level >= 1.0f)
+			{
+				m_level = 1.0f;
+				m_stage = Stage::Decay;
+			}
+			break;
+		case Stage::Decay:
+			m_level -= m_decayStep;
+			if (m_level <= m_sustain)
+			{
+				m_level = m_sustain;
+				m_stage = Stage::Sustain;
+			}
+			break;
+		case Stage::Sustain:
+			// Follows sustain changes while held
+			m_level = m_sustain;
+			break;
+		case Stage::Release:
+			m_level -= m_releaseStep;
+			if (m_level <= 0.0f)
+			{
+				m_level = 0.0f;
+				m_stage = Stage::Idle;
+			}
+			break;
+		default:
+			m_level = 0.0f;
+			break;
+		}
+
+		data[i] *= m_level;
+	}
+}
+
+//==============================================================================
+void NoiseVoiceFilter::setCoefficients(float frequency, float resonance, double sampleRate)
+{
+	// Stays below Nyquist, where tan() blows up
+	const double limited = frequency < 0.45 * sampleRate ? (double)frequency : 0.45 * sampleRate;
+
+	m_g = (float)tan(PI * limited / sampleRate);
+	m_k = 1.0f / (resonance > 0.1f ? resonance : 0.1f);
+	m_a1 = 1.0f / (1.0f + m_g * (m_g + m_k));
+	m_a2 = m_g * m_a1;
+	m_a3 = m_g * m_a2;
+}
+
+void NoiseVoiceFilter::process(float* data, int numSamples, Mode mode)
+{
+	if (mode == Mode::Off)
+		return;
+
+	for (int i = 0; i < numSamples; i++)
+	{
+		const float v0 = data[i];
+		const float v3 = v0 - m_ic2;
+		const float v1 = m_a1 * m_ic1 + m_a2 * v3;
+		const float v2 = m_ic2 + m_a2 * m_ic1 + m_a3 * v3;
+
+		m_ic1 = 2.0f * v1 - m_ic1;
+		m_ic2 = 2.0f * v2 - m_ic2;
+
+		switch (mode)
+		{
+		case Mode::LowPass:		data[i] = v2; break;
+		case Mode::BandPass:	data[i] = v1; break;
+		default:				data[i] = v0 - m_k * v1 - v2; break;
+		}
+	}
+}
+
+//==============================================================================
+void NoiseVoices::prepare(double sampleRate, int maxBlockSize, uint32_t seed, uint32_t firstStream)
+{
+	m_sampleRate = sampleRate;
+	m_scratch.resize((size_t)(maxBlockSize > 0 ? maxBlockSize : 1));
+
+	for (int i = 0; i < MAX_VOICES; i++)
+	{
+		auto& voice = m_voices[i];
+		voice.envelope.reset();
+		voice.filter.reset();
+		voice.note = -1;
+	}
+
+	if (seed != m_seed || firstStream != m_firstStream)
+	{
+		m_seeded.store(false, std::memory_order_relaxed);
+		m_seed = seed;
+		m_firstStream = firstStream;
+	}
+
+	setSettings(m_settings);
+}
+
+void NoiseVoices::seed()
+{
+	// The audio thread does not touch the generators until they are published
+	if (m_seeded.load(std::memory_order_relaxed))
+		return;
+
+	WhiteNoiseGenerator::setStreams(m_generators, MAX_VOICES, m_seed, m_firstStream);
+	m_seeded.store(true, std::memory_order_release);
+}
+
+void NoiseVoices::setSettings(const Settings& settings)
+{
+	m_settings = settings;
+
+	for (auto& voice : m_voices)
+	{
+		voice.envelope.setParameters(settings.envelope, m_sampleRate);
+	}
+
+	if (!m_seeded.load(std::memory_order_acquire))
+		return;
+
+	for (auto& generator : m_generators)
+	{
+		generator.setDistributionType(settings.distributionType);
+		generator.setEngine(settings.engine);
+		generator.setVelvetDensity(settings.velvetDensity);
+		generator.setAliasTable(settings.aliasTable);
+	}
+}
+
+void NoiseVoices::noteOn(int note, float velocity)
+{
+	if (!m_seeded.load(std::memory_order_acquire))
+		return;
+
+	auto& voice = findVoice(note);
+
+	// A stolen voice keeps its filter state and its attack ramps up from the
+	// current level, so stealing does not click
+	voice.note = note;
+	voice.velocity = velocity;
+	voice.age = m_noteCounter++;
+	voice.filter.setCoefficients((float)(440.0 * pow(2.0, (note - 69) / 12.0)), m_settings.resonance, m_sampleRate);
+	voice.envelope.noteOn();
+}
+
+void NoiseVoices::noteOff(int note)
+{
+	for (auto& voice : m_voices)
+	{
+		if (voice.note == note && voice.envelope.isActive() && !voice.envelope.isReleasing())
+			voice.envelope.noteOff();
+	}
+}
+
+void NoiseVoices::allNotesOff()
+{
+	for (auto& voice : m_voices)
+	{
+		voice.envelope.noteOff();
+	}
+}
+
+int NoiseVoices::getNumActiveVoices() const
+{
+	int count = 0;
+	for (const auto& voice : m_voices)
+	{
+		if (voice.envelope.isActive())
+			count++;
+	}
+	return count;
+}
+
+// Same note first, then an idle voice, then the quietest releasing one, then the oldest
+NoiseVoices::Voice& NoiseVoices::findVoice(int note)
+{
+	Voice* idle = nullptr;
+	Voice* releasing = nullptr;
+	Voice* oldest = &m_voices[0];
+
+	for (auto& voice : m_voices)
+	{
+		if (voice.note == note && voice.envelope.isActive())
+			return voice;
+
+		if (!voice.envelope.isActive())
+		{
+			if (idle == nullptr)
+				idle = &voice;
+		}
+		else if (voice.envelope.isReleasing())
+		{
+			if (releasing == nullptr || voice.envelope.getLevel() < releasing->envelope.getLevel())
+				releasing = &voice;
+		}
+
+		if (m_noteCounter - voice.age > m_noteCounter - oldest->age)
+			oldest = &voice;
+	}
+
+	return idle != nullptr ? *idle : releasing != nullptr ? *releasing : *oldest;
+}
+
+//==============================================================================
+template <typename SampleType>
+void NoiseVoices::render(SampleType* const* channelData, int channels, int startSample, int numSamples)
+{
+	const int chunk = (int)m_scratch.size();
+	float* scratch = m_scratch.data();
+
+	for (int index = 0; index < MAX_VOICES; index++)
+	{
+		auto& voice = m_voices[index];
+		if (!voice.envelope.isActive())
+			continue;
+
+		// Blocks longer than prepared for are rendered in pieces
+		for (int done = 0; done < numSamples && voice.envelope.isActive(); done += chunk)
+		{
+			const int count = numSamples - done < chunk ? numSamples - done : chunk;
+
+			m_generators[index].processBlock(scratch, count, voice.velocity);
+			voice.filter.process(scratch, count, m_settings.filterMode);
+			voice.envelope.process(scratch, count);
+
+			for (int channel = 0; channel < channels; channel++)
+			{
+				SampleType* out = channelData[channel] + startSample + done;
+				for (int i = 0; i < count; i++)
+				{
+					out[i] += (SampleType)scratch[i];
+				}
+			}
+		}
+	}
+}
+
+template void NoiseVoices::render<float>(float* const* channelData, int channels, int startSample, int numSamples);
+template void NoiseVoices::render<double>(double* const* channelData, int channels, int startSample, int numSamples);
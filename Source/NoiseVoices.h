@@ -0,0 +1,185 @@
+/*
+  ==============================================================================
+
+    NoiseVoices.h
+    Created: 18 Oct 2026 6:48:19pm
+    Author:  zazz
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "NoiseGenerator.h"
+
+//==============================================================================
+// Linear attack, decay and release around a sustain level, advanced per sample
+class NoiseEnvelope
+{
+public:
+	NoiseEnvelope() {};
+
+	struct Parameters
+	{
+		float attackSeconds = 0.005f;
+		float decaySeconds = 0.1f;
+		float sustain = 0.7f;
+		float releaseSeconds = 0.2f;
+	};
+
+	void setParameters(const Parameters& parameters, double sampleRate);
+
+	// Attack starts from the current level, so a retriggered voice does not click
+	void noteOn()
+	{
+		m_stage = Stage::Attack;
+	}
+	void noteOff()
+	{
+		if (m_stage != Stage::Idle)
+			m_stage = Stage::Release;
+	}
+	void reset()
+	{
+		m_stage = Stage::Idle;
+		m_level = 0.0f;
+	}
+
+	bool isActive() const
+	{
+		return m_stage != Stage::Idle;
+	}
+	bool isReleasing() const
+	{
+		return m_stage == Stage::Release;
+	}
+	float getLevel() const
+	{
+		return m_level;
+	}
+
+	// Multiplies data by the envelope
+	void process(float* data, int numSamples);
+
+private:
+	enum class Stage
+	{
+		Idle,
+		Attack,
+		Decay,
+		Sustain,
+		Release
+	};
+
+	Stage m_stage = Stage::Idle;
+	float m_level = 0.0f;
+
+	// Level change per sample
+	float m_attackStep = 1.0f;
+	float m_decayStep = 1.0f;
+	float m_releaseStep = 1.0f;
+	float m_sustain = 0.7f;
+};
+
+//==============================================================================
+// Topology preserving state variable filter, tuned to the note of its voice
+class NoiseVoiceFilter
+{
+public:
+	NoiseVoiceFilter() {};
+
+	enum Mode
+	{
+		Off,
+		LowPass,
+		BandPass,
+		HighPass
+	};
+
+	void setCoefficients(float frequency, float resonance, double sampleRate);
+	void reset()
+	{
+		m_ic1 = 0.0f;
+		m_ic2 = 0.0f;
+	}
+
+	void process(float* data, int numSamples, Mode mode);
+
+private:
+	float m_g = 0.0f;
+	float m_k = 1.0f;
+	float m_a1 = 1.0f;
+	float m_a2 = 0.0f;
+	float m_a3 = 0.0f;
+
+	float m_ic1 = 0.0f;
+	float m_ic2 = 0.0f;
+};
+
+//==============================================================================
+// Fixed pool of noise voices. Each voice has its own generator stream, envelope
+// and filter, everything is allocated in prepare() so notes can come at any
+// rate and polyphony without touching the heap.
+class NoiseVoices
+{
+public:
+	NoiseVoices() {};
+
+	static const int MAX_VOICES = 32;
+
+	struct Settings
+	{
+		WhiteNoiseGenerator::DistributionType distributionType = WhiteNoiseGenerator::DistributionType::Uniform;
+		NoiseEngine::Type engine = NoiseEngine::Type::MersenneTwister;
+		float velvetDensity = 0.0f;
+		const AliasTable* aliasTable = nullptr;
+		NoiseEnvelope::Parameters envelope;
+		NoiseVoiceFilter::Mode filterMode = NoiseVoiceFilter::Mode::Off;
+		float resonance = 0.7f;
+	};
+
+	// Not thread safe, call while the audio thread is stopped. Only records the
+	// streams, they are seeded again when seed or first stream change.
+	void prepare(double sampleRate, int maxBlockSize, uint32_t seed, uint32_t firstStream);
+
+	// Message thread, seeds the voice streams once voices are first used. Notes
+	// are dropped until then.
+	void seed();
+
+	// Audio thread, once per block before any note
+	void setSettings(const Settings& settings);
+
+	void noteOn(int note, float velocity);
+	void noteOff(int note);
+	void allNotesOff();
+
+	int getNumActiveVoices() const;
+
+	// Adds every active voice to all channels, float or double
+	template <typename SampleType>
+	void render(SampleType* const* channelData, int channels, int startSample, int numSamples);
+
+private:
+	struct Voice
+	{
+		NoiseEnvelope envelope;
+		NoiseVoiceFilter filter;
+		int note = -1;
+		float velocity = 0.0f;
+		uint32_t age = 0;
+	};
+
+	Voice& findVoice(int note);
+
+	Voice m_voices[MAX_VOICES];
+
+	// Apart from the voices, so they are seeded in one call
+	WhiteNoiseGenerator m_generators[MAX_VOICES];
+	uint32_t m_seed = 0;
+	uint32_t m_firstStream = 0;
+	std::atomic<bool> m_seeded{ false };
+	Settings m_settings;
+	std::vector<float> m_scratch;
+	double m_sampleRate = 48000.0;
+	uint32_t m_noteCounter = 0;
+};
@@ -11,7 +11,7 @@
 
 //==============================================================================
 NoiseGeneratorAudioProcessorEditor::NoiseGeneratorAudioProcessorEditor (NoiseGeneratorAudioProcessor& p, juce::AudioProcessorValueTreeState& vts)
-    : AudioProcessorEditor (&p), audioProcessor (p), valueTreeState(vts)
+    : AudioProcessorEditor (&p), audioProcessor (p), valueTreeState(vts), m_analysisView(p.getAnalysisFeed())
 {
 	juce::Colour light = juce::Colour::fromHSV(HUE * 0.01f, 0.5f, 0.6f, 1.0f);
 	juce::Colour medium = juce::Colour::fromHSV(HUE * 0.01f, 0.5f, 0.5f, 1.0f);
@@ -44,33 +44,90 @@ NoiseGeneratorAudioProcessorEditor::NoiseGeneratorAudioProcessorEditor (NoiseGen
 	addAndMakeVisible(typeBButton);
 	addAndMakeVisible(typeCButton);
 	addAndMakeVisible(typeDButton);
+	addAndMakeVisible(typeEButton);
 
 	typeAButton.setRadioGroupId(TYPE_BUTTON_GROUP);
 	typeBButton.setRadioGroupId(TYPE_BUTTON_GROUP);
 	typeCButton.setRadioGroupId(TYPE_BUTTON_GROUP);
 	typeDButton.setRadioGroupId(TYPE_BUTTON_GROUP);
+	typeEButton.setRadioGroupId(TYPE_BUTTON_GROUP);
 
 	typeAButton.setClickingTogglesState(true);
 	typeBButton.setClickingTogglesState(true);
 	typeCButton.setClickingTogglesState(true);
 	typeDButton.setClickingTogglesState(true);
+	typeEButton.setClickingTogglesState(true);
 
 	buttonAAttachment.reset(new juce::AudioProcessorValueTreeState::ButtonAttachment(valueTreeState, "ButtonA", typeAButton));
 	buttonBAttachment.reset(new juce::AudioProcessorValueTreeState::ButtonAttachment(valueTreeState, "ButtonB", typeBButton));
 	buttonCAttachment.reset(new juce::AudioProcessorValueTreeState::ButtonAttachment(valueTreeState, "ButtonC", typeCButton));
 	buttonDAttachment.reset(new juce::AudioProcessorValueTreeState::ButtonAttachment(valueTreeState, "ButtonD", typeDButton));
+	buttonEAttachment.reset(new juce::AudioProcessorValueTreeState::ButtonAttachment(valueTreeState, "ButtonE", typeEButton));
 
 	typeAButton.setColour(juce::TextButton::buttonColourId, light);
 	typeBButton.setColour(juce::TextButton::buttonColourId, light);
 	typeCButton.setColour(juce::TextButton::buttonColourId, light);
 	typeDButton.setColour(juce::TextButton::buttonColourId, light);
+	typeEButton.setColour(juce::TextButton::buttonColourId, light);
 
 	typeAButton.setColour(juce::TextButton::buttonOnColourId, dark);
 	typeBButton.setColour(juce::TextButton::buttonOnColourId, dark);
 	typeCButton.setColour(juce::TextButton::buttonOnColourId, dark);
 	typeDButton.setColour(juce::TextButton::buttonOnColourId, dark);
+	typeEButton.setColour(juce::TextButton::buttonOnColourId, dark);
 
-	setSize((int)(SLIDER_WIDTH * 0.01f * SCALE * N_SLIDERS_COUNT), (int)((SLIDER_WIDTH + BOTTOM_MENU_HEIGHT) * 0.01f * SCALE));
+	// Amplitude PDF
+	m_pdfEditor.setWeights(audioProcessor.getAmplitudeWeights());
+	m_pdfEditor.onChange = [this](const std::vector<float>& weights) { audioProcessor.setAmplitudeWeights(weights); };
+	addAndMakeVisible(m_pdfEditor);
+
+	m_pdfLoadButton.onClick = [this]()
+	{
+		m_pdfFileChooser = std::make_unique<juce::FileChooser>("Load amplitude PDF", juce::File(), "*.txt;*.csv");
+		m_pdfFileChooser->launchAsync(juce::FileBrowserComponent::openMode | juce::FileBrowserComponent::canSelectFiles, [this](const juce::FileChooser& chooser)
+		{
+			const auto file = chooser.getResult();
+			if (!file.existsAsFile())
+				return;
+
+			const auto weights = NoiseGeneratorAudioProcessor::parseAmplitudeWeights(file.loadFileAsString());
+			if (weights.empty())
+				return;
+
+			audioProcessor.setAmplitudeWeights(weights);
+			m_pdfEditor.setWeights(audioProcessor.getAmplitudeWeights());
+		});
+	};
+	m_pdfLoadButton.setColour(juce::TextButton::buttonColourId, light);
+	addAndMakeVisible(m_pdfLoadButton);
+
+	addAndMakeVisible(m_analysisView);
+
+#if NOISE_GENERATOR_PROFILING
+	// DSP load
+	m_loadLabel.setFont(juce::Font(12.0f));
+	m_loadLabel.setJustificationType(juce::Justification::centredLeft);
+	addAndMakeVisible(m_loadLabel);
+
+	m_loadResetButton.onClick = [this]() { audioProcessor.getLoadMeter().reset(); };
+	m_loadDumpButton.onClick = [this]()
+	{
+		const auto file = juce::File::getSpecialLocation(juce::File::userDesktopDirectory).getNonexistentChildFile("NoiseGeneratorLoad", ".csv");
+		const auto result = audioProcessor.getLoadMeter().dumpToFile(file);
+		m_loadLabel.setText(result.wasOk() ? "Written " + file.getFileName() : result.getErrorMessage(), juce::dontSendNotification);
+	};
+	addAndMakeVisible(m_loadResetButton);
+	addAndMakeVisible(m_loadDumpButton);
+
+	m_loadResetButton.setColour(juce::TextButton::buttonColourId, light);
+	m_loadDumpButton.setColour(juce::TextButton::buttonColourId, light);
+
+	startTimerHz(LOAD_REFRESH_HZ);
+
+	setSize((int)(SLIDER_WIDTH * 0.01f * SCALE * N_SLIDERS_COUNT), (int)((SLIDER_WIDTH + BOTTOM_MENU_HEIGHT + PDF_HEIGHT + ANALYSIS_HEIGHT + LOAD_HEIGHT) * 0.01f * SCALE));
+#else
+	setSize((int)(SLIDER_WIDTH * 0.01f * SCALE * N_SLIDERS_COUNT), (int)((SLIDER_WIDTH + BOTTOM_MENU_HEIGHT + PDF_HEIGHT + ANALYSIS_HEIGHT) * 0.01f * SCALE));
+#endif
 }
 
 NoiseGeneratorAudioProcessorEditor::~NoiseGeneratorAudioProcessorEditor()
@@ -104,8 +161,51 @@ void NoiseGeneratorAudioProcessorEditor::resized()
 	const int buttonHeight = (int)(BOTTOM_MENU_HEIGHT * 0.01f * SCALE * 0.5f);
 	const int center = (int)(getWidth() * 0.5f);
 
-	typeAButton.setBounds((int)(center - buttonHeight * 2.4f), posY, buttonHeight, buttonHeight);
-	typeBButton.setBounds((int)(center - buttonHeight * 1.2f), posY, buttonHeight, buttonHeight);
-	typeCButton.setBounds((int)(center + buttonHeight * 0.0f), posY, buttonHeight, buttonHeight);
-	typeDButton.setBounds((int)(center + buttonHeight * 1.2f), posY, buttonHeight, buttonHeight);
-}
\ No newline at end of file
+	typeAButton.setBounds((int)(center - buttonHeight * 3.0f), posY, buttonHeight, buttonHeight);
+	typeBButton.setBounds((int)(center - buttonHeight * 1.8f), posY, buttonHeight, buttonHeight);
+	typeCButton.setBounds((int)(center - buttonHeight * 0.6f), posY, buttonHeight, buttonHeight);
+	typeDButton.setBounds((int)(center + buttonHeight * 0.6f), posY, buttonHeight, buttonHeight);
+	typeEButton.setBounds((int)(center + buttonHeight * 1.8f), posY, buttonHeight, buttonHeight);
+
+	// Amplitude PDF
+	auto pdfArea = juce::Rectangle<int>(0, height + (int)(BOTTOM_MENU_HEIGHT * 0.01f * SCALE), getWidth(), (int)(PDF_HEIGHT * 0.01f * SCALE)).reduced(4, 2);
+	m_pdfLoadButton.setBounds(pdfArea.removeFromRight(40).withSizeKeepingCentre(40, 20));
+	pdfArea.removeFromRight(4);
+	m_pdfEditor.setBounds(pdfArea);
+
+	// Analysis
+	m_analysisView.setBounds(juce::Rectangle<int>(0, height + (int)((BOTTOM_MENU_HEIGHT + PDF_HEIGHT) * 0.01f * SCALE), getWidth(), (int)(ANALYSIS_HEIGHT * 0.01f * SCALE)).reduced(4, 2));
+
+#if NOISE_GENERATOR_PROFILING
+	// DSP load
+	auto loadArea = getLocalBounds().removeFromBottom((int)(LOAD_HEIGHT * 0.01f * SCALE)).reduced(4, 2);
+	m_loadDumpButton.setBounds(loadArea.removeFromRight(40));
+	loadArea.removeFromRight(4);
+	m_loadResetButton.setBounds(loadArea.removeFromRight(40));
+	m_loadLabel.setBounds(loadArea);
+#endif
+}
+
+#if NOISE_GENERATOR_PROFILING
+void NoiseGeneratorAudioProcessorEditor::timerCallback()
+{
+	const auto snapshot = audioProcessor.getLoadMeter().getSnapshot();
+	if (snapshot.blocks == 0)
+		return;
+
+	// Load in percent of real time, block times in microseconds
+	juce::String text = juce::String(snapshot.load * 100.0, 1) + "%  "
+		+ juce::String(snapshot.nanosecondsPerSample, 1) + " ns/smp  "
+		+ "p99 " + juce::String(snapshot.p99Nanoseconds * 0.001, 1) + " us  "
+		+ "max " + juce::String(snapshot.worstNanoseconds * 0.001, 1) + " us";
+
+#if NOISE_GENERATOR_REALTIME_CHECKS
+	// Heap use and blocking calls on the audio and worker threads since start,
+	// both should stay at 0
+	text += "  allocs " + juce::String(RealtimeGuard::getAllocations())
+		+ "  locks " + juce::String(RealtimeGuard::getBlockingCalls());
+#endif
+
+	m_loadLabel.setText(text, juce::dontSendNotification);
+}
+#endif
\ No newline at end of file
@@ -10,9 +10,14 @@
 
 #include <JuceHeader.h>
 #include "PluginProcessor.h"
+#include "AmplitudePdfEditor.h"
+#include "AnalysisView.h"
 
 //==============================================================================
 class NoiseGeneratorAudioProcessorEditor : public juce::AudioProcessorEditor
+#if NOISE_GENERATOR_PROFILING
+	, private juce::Timer
+#endif
 {
 public:
     NoiseGeneratorAudioProcessorEditor (NoiseGeneratorAudioProcessor&, juce::AudioProcessorValueTreeState&);
@@ -28,6 +33,14 @@ public:
 
 	static const int TYPE_BUTTON_GROUP = 1;
 
+	static const int PDF_HEIGHT = 60;
+	static const int ANALYSIS_HEIGHT = 80;
+
+#if NOISE_GENERATOR_PROFILING
+	static const int LOAD_HEIGHT = 30;
+	static const int LOAD_REFRESH_HZ = 4;
+#endif
+
     //==============================================================================
 	void paint (juce::Graphics&) override;
     void resized() override;
@@ -48,11 +61,29 @@ private:
 	juce::TextButton typeBButton{ "B" };
 	juce::TextButton typeCButton{ "C" };
 	juce::TextButton typeDButton{ "D" };
+	juce::TextButton typeEButton{ "E" };
 
 	std::unique_ptr<juce::AudioProcessorValueTreeState::ButtonAttachment> buttonAAttachment;
 	std::unique_ptr<juce::AudioProcessorValueTreeState::ButtonAttachment> buttonBAttachment;
 	std::unique_ptr<juce::AudioProcessorValueTreeState::ButtonAttachment> buttonCAttachment;
 	std::unique_ptr<juce::AudioProcessorValueTreeState::ButtonAttachment> buttonDAttachment;
+	std::unique_ptr<juce::AudioProcessorValueTreeState::ButtonAttachment> buttonEAttachment;
+
+	// Amplitude PDF of button D
+	AmplitudePdfEditor m_pdfEditor;
+	juce::TextButton m_pdfLoadButton{ "Load" };
+	std::unique_ptr<juce::FileChooser> m_pdfFileChooser;
+
+	// Output histogram and spectrum
+	AnalysisView m_analysisView;
+
+#if NOISE_GENERATOR_PROFILING
+	void timerCallback() override;
+
+	juce::Label m_loadLabel;
+	juce::TextButton m_loadResetButton{ "Reset" };
+	juce::TextButton m_loadDumpButton{ "Dump" };
+#endif
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (NoiseGeneratorAudioProcessorEditor)
 };
@@ -8,11 +8,65 @@
 
 #include "PluginProcessor.h"
 #include "PluginEditor.h"
+#include <set>
+
+// Console targets that build the processor have no plugin settings
+#ifndef JucePlugin_Name
+	#define JucePlugin_Name "NoiseGenerator"
+#endif
 
 //==============================================================================
 
 const std::string NoiseGeneratorAudioProcessor::paramsNames[] = { "Volume" };
 
+//==============================================================================
+// Instance indices pick the stream range of an instance. Fresh ones come from
+// the counter, restored states take their saved index back when no live
+// instance holds it, so duplicated instances never share their streams.
+namespace InstanceRegistry
+{
+	static std::mutex mutex;
+	static std::set<uint32_t> claimed;
+	static uint32_t instanceCounter = 0;
+
+	static uint32_t claim()
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+
+		const uint32_t index = instanceCounter++;
+		claimed.insert(index);
+		return index;
+	}
+
+	// Swaps current for saved if saved is free, returns the index to use
+	static uint32_t reclaim(uint32_t current, uint32_t saved)
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+
+		if (saved == current)
+			return current;
+		if (!claimed.insert(saved).second)
+			return current;
+
+		claimed.erase(current);
+		instanceCounter = juce::jmax(instanceCounter, saved + 1);
+		return saved;
+	}
+
+	static void release(uint32_t index)
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		claimed.erase(index);
+	}
+}
+
+// State property holding the user amplitude PDF
+static const juce::Identifier AMPLITUDE_PDF_PROPERTY{ "AmplitudePdf" };
+
+// Binary state, "NGST" in the first four bytes. Later versions only append.
+static const int STATE_MAGIC = 0x5453474e;
+static const int STATE_VERSION = 2;
+
 //==============================================================================
 NoiseGeneratorAudioProcessor::NoiseGeneratorAudioProcessor()
 #ifndef JucePlugin_PreferredChannelConfigurations
@@ -32,10 +86,40 @@ NoiseGeneratorAudioProcessor::NoiseGeneratorAudioProcessor()
 	buttonBParameter = static_cast<juce::AudioParameterBool*>(apvts.getParameter("ButtonB"));
 	buttonCParameter = static_cast<juce::AudioParameterBool*>(apvts.getParameter("ButtonC"));
 	buttonDParameter = static_cast<juce::AudioParameterBool*>(apvts.getParameter("ButtonD"));
+	buttonEParameter = static_cast<juce::AudioParameterBool*>(apvts.getParameter("ButtonE"));
+	prefillParameter = static_cast<juce::AudioParameterBool*>(apvts.getParameter("Prefill"));
+	parallelParameter = static_cast<juce::AudioParameterBool*>(apvts.getParameter("Parallel"));
+	colourParameter = static_cast<juce::AudioParameterChoice*>(apvts.getParameter("Colour"));
+	slopeParameter = apvts.getRawParameterValue("Slope");
+	syncParameter = static_cast<juce::AudioParameterBool*>(apvts.getParameter("Sync"));
+	seedParameter = static_cast<juce::AudioParameterInt*>(apvts.getParameter("Seed"));
+	shapeParameter = static_cast<juce::AudioParameterChoice*>(apvts.getParameter("Shape"));
+	bandParameter = apvts.getRawParameterValue("Band");
+	frameParameter = static_cast<juce::AudioParameterChoice*>(apvts.getParameter("Frame"));
+	densityParameter = apvts.getRawParameterValue("Density");
+	sharedParameter = static_cast<juce::AudioParameterBool*>(apvts.getParameter("Shared"));
+	engineParameter = static_cast<juce::AudioParameterChoice*>(apvts.getParameter("Engine"));
+	bandLimitParameter = static_cast<juce::AudioParameterBool*>(apvts.getParameter("BandLimit"));
+	bandwidthParameter = apvts.getRawParameterValue("Bandwidth");
+	voicesParameter = static_cast<juce::AudioParameterBool*>(apvts.getParameter("Voices"));
+	attackParameter = apvts.getRawParameterValue("Attack");
+	decayParameter = apvts.getRawParameterValue("Decay");
+	sustainParameter = apvts.getRawParameterValue("Sustain");
+	releaseParameter = apvts.getRawParameterValue("Release");
+	filterParameter = static_cast<juce::AudioParameterChoice*>(apvts.getParameter("Filter"));
+	resonanceParameter = apvts.getRawParameterValue("Resonance");
+	ditherParameter = static_cast<juce::AudioParameterChoice*>(apvts.getParameter("Dither"));
+	ditherDepthParameter = static_cast<juce::AudioParameterChoice*>(apvts.getParameter("DitherDepth"));
+
+	m_instanceIndex = InstanceRegistry::claim();
+
+	startTimer(MESSAGE_POLL_MS);
 }
 
 NoiseGeneratorAudioProcessor::~NoiseGeneratorAudioProcessor()
 {
+	stopTimer();
+	InstanceRegistry::release(m_instanceIndex);
 }
 
 //==============================================================================
@@ -104,19 +188,101 @@ void NoiseGeneratorAudioProcessor::changeProgramName (int index, const juce::Str
 void NoiseGeneratorAudioProcessor::prepareToPlay (double sampleRate, int samplesPerBlock)
 {	
 	const int channels = getTotalNumOutputChannels();
-	if (channels <= 1)
-		return;
 
-	// Offset right channel
-	for (int i = 0; i < 48000; i++)
+	// A restored state can move the instance to other streams, every channel then
+	// starts again on its new stream
+	if (m_instanceIndex != m_preparedInstanceIndex)
+	{
+		m_whiteNoiseGenerators.clear();
+		m_sharedReaders.clear();
+		m_preparedInstanceIndex = m_instanceIndex;
+	}
+
+	// Non overlapping streams, no warm up needed. Generators are only ever added,
+	// so a channel keeps its stream across prepare calls.
+	const int preparedChannels = (int)m_whiteNoiseGenerators.size();
+	if (channels > preparedChannels)
+	{
+		m_whiteNoiseGenerators.resize((size_t)channels);
+		WhiteNoiseGenerator::setStreams(m_whiteNoiseGenerators.data() + preparedChannels, channels - preparedChannels, NOISE_SEED, m_instanceIndex * STREAMS_PER_INSTANCE + (uint32_t)preparedChannels);
+	}
+
+	// Readers only ever restart at their own stream, like the generators
+	const int preparedReaders = (int)m_sharedReaders.size();
+	if (channels > preparedReaders)
+	{
+		m_sharedReaders.resize((size_t)channels);
+		for (int channel = preparedReaders; channel < channels; channel++)
+		{
+			m_sharedReaders[(size_t)channel].setStream(SHARED_SEED, m_instanceIndex * STREAMS_PER_INSTANCE + (uint32_t)channel);
+		}
+	}
+
+	// Colour filters depend on the sample rate, so all of them are prepared again
+	m_colouredNoises.resize(m_whiteNoiseGenerators.size());
+	for (size_t channel = 0; channel < m_colouredNoises.size(); channel++)
+	{
+		m_colouredNoises[channel].prepare(sampleRate, m_instanceIndex * STREAMS_PER_INSTANCE + (uint32_t)channel);
+	}
+
+	// Spectral frames are allocated for the largest size, so the size can change while playing
+	m_spectralShape.prepare(sampleRate);
+	m_spectralShape.request((SpectralShape::Shape)shapeParameter->getIndex(), bandParameter->load(), SpectralShape::MIN_ORDER + frameParameter->getIndex());
+	m_spectralShape.update();
+	updateLatency();
+	m_spectralNoises.resize(m_whiteNoiseGenerators.size());
+	for (size_t channel = 0; channel < m_spectralNoises.size(); channel++)
+	{
+		m_spectralNoises[channel].prepare(SPECTRAL_SEED, m_instanceIndex * STREAMS_PER_INSTANCE + (uint32_t)channel);
+	}
+
+	// Internal rate follows the bandwidth, buffers are allocated for the largest factor
+	m_polyphaseInterpolator.prepare(sampleRate);
+	m_bandLimitedNoises.resize(m_whiteNoiseGenerators.size());
+	for (size_t channel = 0; channel < m_bandLimitedNoises.size(); channel++)
 	{
-		m_whiteNoiseGenerator[1].process();
+		m_bandLimitedNoises[channel].prepare(m_instanceIndex * STREAMS_PER_INSTANCE + (uint32_t)channel);
 	}
+
+	// Dither runs on the channel generators, only the error history is its own
+	m_noiseDithers.resize(m_whiteNoiseGenerators.size());
+	for (auto& noiseDither : m_noiseDithers)
+	{
+		noiseDither.reset();
+	}
+
+	// Workers only pay off for wide layouts, and only run while Parallel is on
+	const int workers = channels >= PARALLEL_MIN_CHANNELS ? juce::jmin(juce::SystemStats::getNumCpus() - 1, channels / CHANNELS_PER_WORKER) : 0;
+	m_parallelWorkers = juce::jmax(0, workers);
+	m_channelWorkerPool.prepare(parallelParameter->get() ? m_parallelWorkers : 0);
+
+	// Keep a quarter of a second, and at least a few blocks, generated ahead
+	const int capacity = juce::jmax(4 * samplesPerBlock, (int)(0.25 * sampleRate));
+	m_noiseBank.prepare(channels, capacity, NOISE_SEED, m_instanceIndex * STREAMS_PER_INSTANCE + PREFILL_STREAM_OFFSET);
+	if (prefillParameter->get())
+		m_noiseBank.start();
+
+	m_gainRamp.prepare(sampleRate, GAIN_RAMP_SECONDS);
+
+	// Voices have their own seed, so their streams never meet the channel streams.
+	// Seeding them waits until Voices is on.
+	m_noiseVoices.prepare(sampleRate, samplesPerBlock, VOICE_SEED, m_instanceIndex * STREAMS_PER_INSTANCE);
+	if (voicesParameter->get())
+		m_noiseVoices.seed();
+
+	m_analysisFeed.prepare(sampleRate);
+
+#if NOISE_GENERATOR_PROFILING
+	m_loadMeter.prepare(sampleRate);
+#endif
 }
 
 void NoiseGeneratorAudioProcessor::releaseResources()
 {
-	
+	m_noiseBank.release();
+	m_parallelWorkers = 0;
+	m_channelWorkerPool.release();
+	m_analysisFeed.release();
 }
 
 #ifndef JucePlugin_PreferredChannelConfigurations
@@ -126,12 +292,9 @@ bool NoiseGeneratorAudioProcessor::isBusesLayoutSupported (const BusesLayout& la
     juce::ignoreUnused (layouts);
     return true;
   #else
-    // This is the place where you check if the layout is supported.
-    // In this template code we only support mono or stereo.
-    // Some plugin hosts, such as certain GarageBand versions, will only
-    // load plugins that support stereo bus layouts.
-    if (layouts.getMainOutputChannelSet() != juce::AudioChannelSet::mono()
-     && layouts.getMainOutputChannelSet() != juce::AudioChannelSet::stereo())
+    // Any layout works, every channel gets its own stream
+    const auto& output = layouts.getMainOutputChannelSet();
+    if (output.isDisabled() || output.size() > MAX_CHANNELS)
         return false;
 
     // This checks if the input layout matches the output layout
@@ -147,48 +310,413 @@ bool NoiseGeneratorAudioProcessor::isBusesLayoutSupported (const BusesLayout& la
 
 void NoiseGeneratorAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages)
 {
+#if NOISE_GENERATOR_REALTIME_CHECKS
+	const RealtimeGuard::Scope realtimeScope;
+#endif
+
+	processSamples(buffer, midiMessages);
+}
+
+void NoiseGeneratorAudioProcessor::processBlock (juce::AudioBuffer<double>& buffer, juce::MidiBuffer& midiMessages)
+{
+#if NOISE_GENERATOR_REALTIME_CHECKS
+	const RealtimeGuard::Scope realtimeScope;
+#endif
+
+	processSamples(buffer, midiMessages);
+}
+
+bool NoiseGeneratorAudioProcessor::supportsDoublePrecisionProcessing() const
+{
+	return true;
+}
+
+template <typename SampleType>
+void NoiseGeneratorAudioProcessor::processSamples(juce::AudioBuffer<SampleType>& buffer, juce::MidiBuffer& midiMessages)
+{
+#if NOISE_GENERATOR_PROFILING
+	const uint64_t loadStart = DspLoadMeter::now();
+#endif
+
 	// Buttons
 	const auto buttonA = buttonAParameter->get();
 	const auto buttonB = buttonBParameter->get();
 	const auto buttonC = buttonCParameter->get();
 	const auto buttonD = buttonDParameter->get();
+	const auto buttonE = buttonEParameter->get();
+
+	auto distributionType = WhiteNoiseGenerator::DistributionType::Uniform;
+	if (buttonB)
+		distributionType = WhiteNoiseGenerator::DistributionType::Normal;
+	else if (buttonC)
+		distributionType = WhiteNoiseGenerator::DistributionType::Bernoulli;
+	else if (buttonD)
+		distributionType = WhiteNoiseGenerator::DistributionType::PieceWise;
+	else if (buttonE)
+		distributionType = WhiteNoiseGenerator::DistributionType::Velvet;
+
+	// Dither mode reduces the word length of the input instead of generating
+	// noise, each channel is dithered with its own uniform stream
+	const auto dither = (NoiseDither::Type)ditherParameter->getIndex();
+	const bool dithering = dither != NoiseDither::Type::Off;
+
+	// In voice mode MIDI notes play the selected distribution, everything else is
+	// off. Notes still held when it is switched off are released.
+	const bool voices = voicesParameter->get() && !dithering;
+	if (!voices)
+		m_noiseVoices.allNotesOff();
+
+	// Spectral noise is close to normal, so it gets the same trim
+	const auto shape = (SpectralShape::Shape)shapeParameter->getIndex();
+	const bool spectral = shape != SpectralShape::Shape::Off && !voices && !dithering;
+	const auto levelType = spectral ? WhiteNoiseGenerator::DistributionType::Normal : distributionType;
 
 	// Get params
 	float volume = 0.0f;
-	if (buttonA)
-		volume = juce::Decibels::decibelsToGain(volumeParameter->load()) * juce::Decibels::decibelsToGain(-42.0f);
-	else if (buttonB)
-		volume = juce::Decibels::decibelsToGain(volumeParameter->load()) * juce::Decibels::decibelsToGain(-43.0f);
-	else if (buttonC)
-		volume = juce::Decibels::decibelsToGain(volumeParameter->load()) * juce::Decibels::decibelsToGain(-47.0f);
-	else if (buttonD)	
-		volume = juce::Decibels::decibelsToGain(volumeParameter->load()) * juce::Decibels::decibelsToGain(-31.0f);
+	if ((buttonA || buttonB || buttonC || buttonD || buttonE) && volumeParameter->load() > MIN_VOLUME_DECIBELS)
+		volume = juce::Decibels::decibelsToGain(volumeParameter->load()) * juce::Decibels::decibelsToGain(WhiteNoiseGenerator::getLevelTrim(levelType));
 
 	// Mics constants
-	const int channels = getTotalNumOutputChannels();
+	const int channels = juce::jmin(getTotalNumOutputChannels(), buffer.getNumChannels(), (int)m_whiteNoiseGenerators.size());
 	const int samples = buffer.getNumSamples();		
 
+	// Volume changes ramp over the same time whatever the block size
+	m_gainRamp.setTarget(volume);
+	m_renderContext.gain = m_gainRamp.advance(samples);
+
+	// Coloured or ramped noise is generated at unity level, the gain is applied after shaping
+	const auto colour = (ColouredNoise::Colour)colourParameter->getIndex();
+	m_renderContext.colour = colour;
+	m_renderContext.applyGain = colour != ColouredNoise::Colour::White || m_renderContext.gain.length > 0;
+	m_renderContext.generatorGain = m_renderContext.applyGain ? 1.0f : volume;
+	m_renderContext.blockSize = samples;
+
+	// Synced noise follows the host playhead, so every bounce renders the same
+	// samples. While stopped it runs on from its own position.
+	const bool sync = syncParameter->get();
+	m_renderContext.sync = sync;
+	m_renderContext.seed = NOISE_SEED + (uint32_t)seedParameter->get();
+	m_renderContext.position = m_freeRunPosition.fetch_add((uint64_t)samples, std::memory_order_relaxed);
+
+	if (sync)
+	{
+		if (auto* playHead = getPlayHead())
+		{
+			const auto position = playHead->getPosition();
+			if (position.hasValue() && position->getIsPlaying() && position->getTimeInSamples().hasValue())
+				m_renderContext.position = (uint64_t)*position->getTimeInSamples();
+		}
+	}
+
+	// Shape and frame size only change between blocks. Magnitudes are built on the
+	// message thread, offline renders build them here as the timer may not run
+	// between blocks.
+	m_renderContext.spectral = spectral;
+	if (spectral)
+	{
+		if (isNonRealtime())
+			m_spectralShape.request(shape, bandParameter->load(), SpectralShape::MIN_ORDER + frameParameter->getIndex());
+		m_spectralShape.update();
+	}
+
+	// Band limited noise runs on the streaming generators, synced and spectral
+	// noise stay at the full rate
+	const bool bandLimited = bandLimitParameter->get() && !voices && !dithering && !sync && !spectral;
+	m_renderContext.bandLimited = bandLimited;
+	if (bandLimited)
+		m_polyphaseInterpolator.setBandwidth(bandwidthParameter->load());
+
+	// Custom slope is designed here once for all channels, band limited noise
+	// colours at the internal rate
+	if (colour == ColouredNoise::Colour::Custom)
+	{
+		auto& slope = bandLimited ? m_bandLimitedSlope : m_slope;
+		slope.design(bandLimited ? m_polyphaseInterpolator.getInternalRate() : getSampleRate(), slopeParameter->load());
+		m_renderContext.slope = &slope;
+	}
+
+	// Density is set in impulses per second
+	const bool velvet = distributionType == WhiteNoiseGenerator::DistributionType::Velvet;
+	m_renderContext.velvetDensity = (float)(densityParameter->load() / getSampleRate());
+
+	// Tables and the prefill ring hold Mersenne Twister noise, other engines are
+	// always generated inline
+	m_renderContext.engine = (NoiseEngine::Type)engineParameter->getIndex();
+	const bool mersenneTwister = m_renderContext.engine == NoiseEngine::Type::MersenneTwister;
+
+	// Newest user PDF, swapped in between blocks
+	m_renderContext.aliasTable = m_aliasTables.acquire();
+	const bool customPdf = distributionType == WhiteNoiseGenerator::DistributionType::PieceWise && m_renderContext.aliasTable != nullptr;
+
+	// Shared tables hold the same noise the generators would make, synced and user
+	// PDF noise is specific to this instance. Until the message thread has picked
+	// up the request and the table is ready the generators carry on.
+	m_renderContext.sharedTable = nullptr;
+	if (sharedParameter->get() && mersenneTwister && !voices && !dithering && !bandLimited && !sync && !spectral && !velvet && !customPdf)
+	{
+		m_renderContext.sharedTable = m_sharedTables[(int)distributionType].load(std::memory_order_acquire);
+		if (m_renderContext.sharedTable == nullptr)
+		{
+			m_sharedTableRequests.fetch_or(1u << (int)distributionType, std::memory_order_relaxed);
+		}
+	}
+
+	// Prefilled noise first, whatever the ring could not cover is generated inline.
+	// Voices, dither, band limited, synced, spectral, velvet, user PDF and shared
+	// noise are not generated ahead, the ring only holds float.
+	constexpr bool floatSamples = std::is_same<SampleType, float>::value;
+	const bool prefill = floatSamples && prefillParameter->get() && mersenneTwister && !voices && !dithering && !bandLimited && !sync && !spectral && !velvet && !customPdf && m_renderContext.sharedTable == nullptr;
+	m_noiseBank.setEnabled(prefill);
+	m_noiseBank.setDistributionType(distributionType);
+
+	// Once the volume has ramped down to nothing the buffer is cleared and no
+	// generator runs. Every stream keeps its place and continues from there, so
+	// nothing has to catch up when the volume comes back. A cleared buffer is
+	// flagged as silent to the host wrapper. Voices keep running, so their
+	// envelopes stay in time with the notes. Dither ignores the volume.
+	if (dithering)
+	{
+		const auto depth = (NoiseDither::Depth)ditherDepthParameter->getIndex();
+
+		// Outputs without an input are silent
+		for (int channel = getTotalNumInputChannels(); channel < channels; channel++)
+		{
+			buffer.clear(channel, 0, samples);
+		}
+
+		for (int channel = 0; channel < channels; channel++)
+		{
+			auto& whiteNoiseGenerator = m_whiteNoiseGenerators[(size_t)channel];
+			whiteNoiseGenerator.setEngine(m_renderContext.engine);
+			m_noiseDithers[(size_t)channel].process(whiteNoiseGenerator, buffer.getWritePointer(channel), samples, dither, depth);
+		}
+	}
+	else if (voices)
+	{
+		NoiseVoices::Settings settings;
+		settings.distributionType = distributionType;
+		settings.engine = m_renderContext.engine;
+		settings.velvetDensity = m_renderContext.velvetDensity;
+		settings.aliasTable = m_renderContext.aliasTable;
+		settings.envelope.attackSeconds = attackParameter->load();
+		settings.envelope.decaySeconds = decayParameter->load();
+		settings.envelope.sustain = sustainParameter->load();
+		settings.envelope.releaseSeconds = releaseParameter->load();
+		settings.filterMode = (NoiseVoiceFilter::Mode)filterParameter->getIndex();
+		settings.resonance = resonanceParameter->load();
+		m_noiseVoices.setSettings(settings);
+
+		buffer.clear();
+		renderVoices(buffer, midiMessages, channels);
+	}
+	else if (m_renderContext.gain.isSilent())
+	{
+		buffer.clear();
+	}
+	else
+	{
+		int prefilled = 0;
+		if constexpr (floatSamples)
+		{
+			if (prefill)
+				prefilled = m_noiseBank.read(buffer.getArrayOfWritePointers(), channels, samples, m_renderContext.generatorGain);
+		}
+
+		// Mode is resolved once per block, each case is a specialised loop
+		switch (distributionType)
+		{
+		case WhiteNoiseGenerator::DistributionType::Uniform:	renderNoise<WhiteNoiseGenerator::DistributionType::Uniform, SampleType>(buffer, channels, prefilled); break;
+		case WhiteNoiseGenerator::DistributionType::Normal:		renderNoise<WhiteNoiseGenerator::DistributionType::Normal, SampleType>(buffer, channels, prefilled); break;
+		case WhiteNoiseGenerator::DistributionType::Bernoulli:	renderNoise<WhiteNoiseGenerator::DistributionType::Bernoulli, SampleType>(buffer, channels, prefilled); break;
+		case WhiteNoiseGenerator::DistributionType::PieceWise:	renderNoise<WhiteNoiseGenerator::DistributionType::PieceWise, SampleType>(buffer, channels, prefilled); break;
+		default:												renderNoise<WhiteNoiseGenerator::DistributionType::Velvet, SampleType>(buffer, channels, prefilled); break;
+		}
+	}
+
+	// Dropped if the editor is closed or the analysis falls behind
+	if (channels > 0)
+		m_analysisFeed.push(buffer.getReadPointer(0), samples);
+
+#if NOISE_GENERATOR_PROFILING
+	m_loadMeter.end(loadStart, samples);
+#endif
+}
+
+template <typename SampleType>
+void NoiseGeneratorAudioProcessor::renderVoices(juce::AudioBuffer<SampleType>& buffer, const juce::MidiBuffer& midiMessages, int channels)
+{
+	SampleType* const* channelData = buffer.getArrayOfWritePointers();
+	const int samples = buffer.getNumSamples();
+	int position = 0;
+
+	for (const auto metadata : midiMessages)
+	{
+		const int eventPosition = juce::jlimit(position, samples, metadata.samplePosition);
+		if (eventPosition > position)
+		{
+			m_noiseVoices.render(channelData, channels, position, eventPosition - position);
+			position = eventPosition;
+		}
+
+		const auto message = metadata.getMessage();
+		if (message.isNoteOn())
+			m_noiseVoices.noteOn(message.getNoteNumber(), message.getFloatVelocity());
+		else if (message.isNoteOff())
+			m_noiseVoices.noteOff(message.getNoteNumber());
+		else if (message.isAllNotesOff() || message.isAllSoundOff())
+			m_noiseVoices.allNotesOff();
+	}
+
+	if (samples > position)
+		m_noiseVoices.render(channelData, channels, position, samples - position);
+
+	// Voices are summed at velocity level, volume and trim come last
 	for (int channel = 0; channel < channels; ++channel)
 	{
-		auto* channelBuffer = buffer.getWritePointer(channel);
-		auto& whiteNoiseGenerator = m_whiteNoiseGenerator[channel];
+		GainRamp::apply(channelData[channel], samples, m_renderContext.gain);
+	}
+}
+
+template <WhiteNoiseGenerator::DistributionType type, typename SampleType>
+void NoiseGeneratorAudioProcessor::renderNoise(juce::AudioBuffer<SampleType>& buffer, int channels, int startSample)
+{
+	m_renderContext.processor = this;
+
+	if constexpr (std::is_same<SampleType, double>::value)
+		m_renderContext.doubleChannelData = buffer.getArrayOfWritePointers();
+	else
+		m_renderContext.channelData = buffer.getArrayOfWritePointers();
 
-		if (buttonA)
-			whiteNoiseGenerator.setDistributionType(WhiteNoiseGenerator::DistributionType::Uniform);
-		else if (buttonB)
-			whiteNoiseGenerator.setDistributionType(WhiteNoiseGenerator::DistributionType::Normal);
-		else if (buttonC)
-			whiteNoiseGenerator.setDistributionType(WhiteNoiseGenerator::DistributionType::Bernoulli);
-		else if (buttonD)	
-			whiteNoiseGenerator.setDistributionType(WhiteNoiseGenerator::DistributionType::PieceWise);
+	m_renderContext.startSample = startSample;
+	m_renderContext.numSamples = buffer.getNumSamples() - startSample;
 
-		for (int sample = 0; sample < samples; ++sample)
+	if (parallelParameter->get() && m_channelWorkerPool.getNumWorkers() > 0)
+	{
+		m_channelWorkerPool.process(&NoiseGeneratorAudioProcessor::renderChannel<type, SampleType>, &m_renderContext, channels);
+	}
+	else
+	{
+		for (int channel = 0; channel < channels; ++channel)
 		{
-			channelBuffer[sample] = volume * whiteNoiseGenerator.process();
+			renderChannel<type, SampleType>(&m_renderContext, channel);
 		}
 	}
 }
 
+template <WhiteNoiseGenerator::DistributionType type, typename SampleType>
+void NoiseGeneratorAudioProcessor::renderChannel(void* context, int channel)
+{
+	const auto& renderContext = *static_cast<RenderContext*>(context);
+	auto& whiteNoiseGenerator = renderContext.processor->m_whiteNoiseGenerators[(size_t)channel];
+	SampleType* const channelData = renderContext.getChannel<SampleType>(channel);
+
+	whiteNoiseGenerator.setDistributionType(type);
+	whiteNoiseGenerator.setEngine(renderContext.engine);
+
+	if constexpr (type == WhiteNoiseGenerator::DistributionType::Velvet)
+		whiteNoiseGenerator.setVelvetDensity(renderContext.velvetDensity);
+
+	if constexpr (type == WhiteNoiseGenerator::DistributionType::PieceWise)
+		whiteNoiseGenerator.setAliasTable(renderContext.aliasTable);
+
+	if (renderContext.spectral)
+	{
+		auto& spectralNoise = renderContext.processor->m_spectralNoises[(size_t)channel];
+		spectralNoise.process(channelData + renderContext.startSample, renderContext.numSamples, renderContext.generatorGain, renderContext.processor->m_spectralShape);
+	}
+	else if (renderContext.bandLimited)
+	{
+		// Velvet density is per internal sample here
+		const auto& interpolator = renderContext.processor->m_polyphaseInterpolator;
+		if constexpr (type == WhiteNoiseGenerator::DistributionType::Velvet)
+			whiteNoiseGenerator.setVelvetDensity(renderContext.velvetDensity * (float)interpolator.getFactor());
+
+		auto& bandLimitedNoise = renderContext.processor->m_bandLimitedNoises[(size_t)channel];
+		bandLimitedNoise.process(whiteNoiseGenerator, interpolator, channelData + renderContext.startSample, renderContext.numSamples, renderContext.generatorGain, renderContext.colour, renderContext.slope);
+	}
+	else if (renderContext.sharedTable != nullptr)
+	{
+		auto& sharedReader = renderContext.processor->m_sharedReaders[(size_t)channel];
+		sharedReader.read(*renderContext.sharedTable, channelData + renderContext.startSample, renderContext.numSamples, renderContext.generatorGain);
+	}
+	else if (renderContext.sync)
+	{
+		whiteNoiseGenerator.setCounterKey(renderContext.seed, (uint32_t)channel);
+		whiteNoiseGenerator.processBlockAt<type>(renderContext.position + (uint64_t)renderContext.startSample, channelData + renderContext.startSample, renderContext.numSamples, renderContext.generatorGain);
+	}
+	else
+	{
+		whiteNoiseGenerator.processBlock<type>(channelData + renderContext.startSample, renderContext.numSamples, renderContext.generatorGain);
+	}
+
+	if (renderContext.colour != ColouredNoise::Colour::White && !renderContext.bandLimited)
+	{
+		auto& colouredNoise = renderContext.processor->m_colouredNoises[(size_t)channel];
+
+		colouredNoise.setColour(renderContext.colour, renderContext.slope);
+
+		if (renderContext.sync)
+		{
+			colouredNoise.setCounterKey(renderContext.seed, (uint32_t)channel);
+			colouredNoise.processAt(renderContext.position, channelData, renderContext.blockSize);
+		}
+		else
+		{
+			colouredNoise.process(channelData, renderContext.blockSize);
+		}
+	}
+
+	if (renderContext.applyGain)
+		GainRamp::apply(channelData, renderContext.blockSize, renderContext.gain);
+}
+
+//==============================================================================
+void NoiseGeneratorAudioProcessor::timerCallback()
+{
+	const uint32_t requests = m_sharedTableRequests.exchange(0, std::memory_order_relaxed);
+
+	for (int type = 0; type < SharedNoiseTable::NUM_TYPES; type++)
+	{
+		if ((requests & (1u << type)) == 0 || m_sharedTableHolders[type] != nullptr)
+			continue;
+
+		m_sharedTableHolders[type] = SharedNoiseTable::acquire((WhiteNoiseGenerator::DistributionType)type);
+		m_sharedTables[type].store(m_sharedTableHolders[type].get(), std::memory_order_release);
+	}
+
+	// The prefill ring is allocated, seeded and filled once Prefill is first on
+	if (prefillParameter->get())
+		m_noiseBank.start();
+	else
+		m_noiseBank.stop();
+
+	// Voice streams are seeded once Voices is first on
+	if (voicesParameter->get())
+		m_noiseVoices.seed();
+
+	// Spectral magnitudes are built here and taken by the next block
+	if (!isNonRealtime())
+		m_spectralShape.request((SpectralShape::Shape)shapeParameter->getIndex(), bandParameter->load(), SpectralShape::MIN_ORDER + frameParameter->getIndex());
+	updateLatency();
+
+	// Stopping is safe mid block, the audio thread runs whatever no worker claimed
+	const int workers = parallelParameter->get() ? m_parallelWorkers : 0;
+	if (workers != m_channelWorkerPool.getNumWorkers())
+		m_channelWorkerPool.prepare(workers);
+}
+
+void NoiseGeneratorAudioProcessor::updateLatency()
+{
+	// The same conditions processSamples runs spectral noise under
+	const bool dithering = (NoiseDither::Type)ditherParameter->getIndex() != NoiseDither::Type::Off;
+	const bool voices = voicesParameter->get() && !dithering;
+	const bool spectral = (SpectralShape::Shape)shapeParameter->getIndex() != SpectralShape::Shape::Off && !voices && !dithering;
+
+	const int latency = spectral ? SpectralShape::getLatencySamples(SpectralShape::MIN_ORDER + frameParameter->getIndex()) : 0;
+	if (latency != getLatencySamples())
+		setLatencySamples(latency);
+}
+
 //==============================================================================
 bool NoiseGeneratorAudioProcessor::hasEditor() const
 {
@@ -203,18 +731,200 @@ juce::AudioProcessorEditor* NoiseGeneratorAudioProcessor::createEditor()
 //==============================================================================
 void NoiseGeneratorAudioProcessor::getStateInformation (juce::MemoryBlock& destData)
 {	
-	auto state = apvts.copyState();
-	std::unique_ptr<juce::XmlElement> xml(state.createXml());
-	copyXmlToBinary(*xml, destData);
+	juce::MemoryOutputStream stream(destData, false);
+	stream.writeInt(STATE_MAGIC);
+	stream.writeInt(STATE_VERSION);
+
+	// Generators are described by seed, first stream and free run position, never
+	// by their state
+	stream.writeInt((int)NOISE_SEED);
+	stream.writeInt((int)(m_instanceIndex * STREAMS_PER_INSTANCE));
+	stream.writeInt64((juce::int64)m_freeRunPosition.load(std::memory_order_relaxed));
+
+	// Normalised values keyed by their ID
+	const auto& parameters = getParameters();
+	stream.writeInt(parameters.size());
+	for (auto* parameter : parameters)
+	{
+		const auto* parameterWithID = dynamic_cast<const juce::AudioProcessorParameterWithID*>(parameter);
+		stream.writeString(parameterWithID != nullptr ? parameterWithID->paramID : juce::String());
+		stream.writeFloat(parameter->getValue());
+	}
+
+	stream.writeInt((int)m_amplitudeWeights.size());
+	for (const float weight : m_amplitudeWeights)
+	{
+		stream.writeFloat(weight);
+	}
 }
 
 void NoiseGeneratorAudioProcessor::setStateInformation (const void* data, int sizeInBytes)
 {
+	if (setBinaryState(data, sizeInBytes))
+		return;
+
+	// Sessions saved before the binary state hold the parameter tree as XML
 	std::unique_ptr<juce::XmlElement> xmlState(getXmlFromBinary(data, sizeInBytes));
 
 	if (xmlState.get() != nullptr)
 		if (xmlState->hasTagName(apvts.state.getType()))
 			apvts.replaceState(juce::ValueTree::fromXml(*xmlState));
+
+	// States without a PDF get the default shape
+	const auto weights = parseAmplitudeWeights(apvts.state.getProperty(AMPLITUDE_PDF_PROPERTY).toString());
+	if (!weights.empty() || !m_amplitudeWeights.empty())
+		setAmplitudeWeights(weights);
+}
+
+bool NoiseGeneratorAudioProcessor::setBinaryState(const void* data, int sizeInBytes)
+{
+	if (data == nullptr || sizeInBytes < 8)
+		return false;
+
+	juce::MemoryInputStream stream(data, (size_t)sizeInBytes, false);
+	if (stream.readInt() != STATE_MAGIC)
+		return false;
+
+	const int version = stream.readInt();
+	if (version < 1)
+		return false;
+
+	// Everything is read before anything is applied, so a truncated state changes nothing
+	const uint32_t seed = (uint32_t)stream.readInt();
+	const uint32_t firstStream = (uint32_t)stream.readInt();
+	const uint64_t position = (uint64_t)stream.readInt64();
+
+	// Version 1 keyed the values by the 32 bit hash of their ID, they are matched
+	// back to IDs here
+	const int numValues = stream.readInt();
+	const int minValueSize = version >= 2 ? 5 : 8;
+	if (numValues < 0 || stream.getNumBytesRemaining() < (juce::int64)numValues * minValueSize + 4)
+		return false;
+
+	std::vector<std::pair<juce::String, float>> values((size_t)numValues);
+	for (auto& value : values)
+	{
+		if (stream.getNumBytesRemaining() < minValueSize)
+			return false;
+
+		if (version >= 2)
+		{
+			value.first = stream.readString();
+		}
+		else
+		{
+			const int hash = stream.readInt();
+			for (auto* parameter : getParameters())
+			{
+				const auto* parameterWithID = dynamic_cast<const juce::AudioProcessorParameterWithID*>(parameter);
+				if (parameterWithID != nullptr && parameterWithID->paramID.hashCode() == hash)
+				{
+					value.first = parameterWithID->paramID;
+					break;
+				}
+			}
+		}
+
+		value.second = stream.readFloat();
+	}
+
+	if (stream.getNumBytesRemaining() < 4)
+		return false;
+
+	const int numWeights = stream.readInt();
+	if (numWeights < 0 || numWeights > AliasTable::MAX_BINS || stream.getNumBytesRemaining() < (juce::int64)numWeights * 4)
+		return false;
+
+	std::vector<float> weights((size_t)numWeights);
+	for (auto& weight : weights)
+	{
+		weight = stream.readFloat();
+	}
+
+	// Parameters missing from the state go back to their defaults. Restoring is not
+	// a user edit, so the host is not told, only the parameter's listeners.
+	for (auto* parameter : getParameters())
+	{
+		const auto* parameterWithID = dynamic_cast<const juce::AudioProcessorParameterWithID*>(parameter);
+		if (parameterWithID == nullptr)
+			continue;
+
+		float normalised = parameter->getDefaultValue();
+		for (const auto& value : values)
+		{
+			if (value.first == parameterWithID->paramID)
+			{
+				normalised = value.second;
+				break;
+			}
+		}
+
+		if (normalised != parameter->getValue())
+		{
+			parameter->setValue(normalised);
+			parameter->sendValueChangedMessageToListeners(normalised);
+		}
+	}
+
+	if (!weights.empty() || !m_amplitudeWeights.empty())
+		setAmplitudeWeights(weights);
+
+	// Streams of another seed cannot be matched, the instance then keeps its own.
+	// So does a copy of a state whose streams a live instance still holds. Synced
+	// noise continues from the saved position straight away, the streams move at
+	// the next prepareToPlay. New instances start after every restored one.
+	if (seed == NOISE_SEED && firstStream % STREAMS_PER_INSTANCE == 0)
+	{
+		const uint32_t savedIndex = firstStream / STREAMS_PER_INSTANCE;
+		if (InstanceRegistry::reclaim(m_instanceIndex, savedIndex) == savedIndex)
+		{
+			m_instanceIndex = savedIndex;
+			m_freeRunPosition.store(position, std::memory_order_relaxed);
+		}
+	}
+
+	return true;
+}
+
+//==============================================================================
+void NoiseGeneratorAudioProcessor::setAmplitudeWeights(const std::vector<float>& weights)
+{
+	const int numBins = juce::jmin((int)weights.size(), AliasTable::MAX_BINS);
+
+	auto table = std::make_unique<AliasTable>(AliasTable::getDefault());
+	if (numBins > 0)
+		table->build(weights.data(), numBins);
+
+	m_amplitudeWeights.assign(weights.begin(), weights.begin() + numBins);
+	m_aliasTables.submit(std::move(table));
+
+	if (m_amplitudeWeights.empty())
+	{
+		apvts.state.removeProperty(AMPLITUDE_PDF_PROPERTY, nullptr);
+		return;
+	}
+
+	juce::StringArray values;
+	for (const float weight : m_amplitudeWeights)
+		values.add(juce::String(weight));
+
+	apvts.state.setProperty(AMPLITUDE_PDF_PROPERTY, values.joinIntoString(","), nullptr);
+}
+
+std::vector<float> NoiseGeneratorAudioProcessor::parseAmplitudeWeights(const juce::String& text)
+{
+	juce::StringArray tokens;
+	tokens.addTokens(text, ", \t\r\n", "");
+	tokens.removeEmptyStrings();
+
+	std::vector<float> weights;
+	for (const auto& token : tokens)
+	{
+		if (token.containsOnly("0123456789.-+eE"))
+			weights.push_back(token.getFloatValue());
+	}
+
+	return weights;
 }
 
 juce::AudioProcessorValueTreeState::ParameterLayout NoiseGeneratorAudioProcessor::createParameterLayout()
@@ -223,12 +933,46 @@ juce::AudioProcessorValueTreeState::ParameterLayout NoiseGeneratorAudioProcessor
 
 	using namespace juce;
 
-	layout.add(std::make_unique<juce::AudioParameterFloat>(paramsNames[0], paramsNames[0], NormalisableRange<float>(-24.0f, 24.0f,   0.1f, 1.0f), 0.0f));
+	layout.add(std::make_unique<juce::AudioParameterFloat>(paramsNames[0], paramsNames[0], NormalisableRange<float>(MIN_VOLUME_DECIBELS, 24.0f, 0.1f, 1.0f), 0.0f));
 
 	layout.add(std::make_unique<juce::AudioParameterBool>("ButtonA", "ButtonA", true));
 	layout.add(std::make_unique<juce::AudioParameterBool>("ButtonB", "ButtonB", false));
 	layout.add(std::make_unique<juce::AudioParameterBool>("ButtonC", "ButtonC", false));
 	layout.add(std::make_unique<juce::AudioParameterBool>("ButtonD", "ButtonC", false));
+	layout.add(std::make_unique<juce::AudioParameterBool>("ButtonE", "ButtonE", false));
+
+	layout.add(std::make_unique<juce::AudioParameterBool>("Prefill", "Prefill", false));
+	layout.add(std::make_unique<juce::AudioParameterBool>("Parallel", "Parallel", false));
+
+	layout.add(std::make_unique<juce::AudioParameterChoice>("Colour", "Colour", StringArray{ "White", "Pink", "Brown", "Blue", "Violet", "Custom" }, 0));
+	layout.add(std::make_unique<juce::AudioParameterFloat>("Slope", "Slope", NormalisableRange<float>(-ColouredNoise::MAX_SLOPE, ColouredNoise::MAX_SLOPE, 0.1f, 1.0f), -3.0f));
+
+	layout.add(std::make_unique<juce::AudioParameterBool>("Sync", "Sync", false));
+	layout.add(std::make_unique<juce::AudioParameterInt>("Seed", "Seed", 0, 65535, 0));
+
+	layout.add(std::make_unique<juce::AudioParameterChoice>("Shape", "Shape", StringArray{ "Off", "Speech", "Octave", "Notch" }, 0));
+	layout.add(std::make_unique<juce::AudioParameterFloat>("Band", "Band", NormalisableRange<float>(20.0f, 20000.0f, 1.0f, 0.25f), 1000.0f));
+	layout.add(std::make_unique<juce::AudioParameterChoice>("Frame", "Frame", StringArray{ "512", "1024", "2048", "4096", "8192" }, 2));
+
+	layout.add(std::make_unique<juce::AudioParameterFloat>("Density", "Density", NormalisableRange<float>(100.0f, 10000.0f, 1.0f, 0.3f), 2000.0f));
+
+	layout.add(std::make_unique<juce::AudioParameterBool>("Shared", "Shared", false));
+
+	layout.add(std::make_unique<juce::AudioParameterBool>("BandLimit", "BandLimit", false));
+	layout.add(std::make_unique<juce::AudioParameterFloat>("Bandwidth", "Bandwidth", NormalisableRange<float>(20.0f, 20000.0f, 1.0f, 0.25f), 500.0f));
+
+	layout.add(std::make_unique<juce::AudioParameterChoice>("Engine", "Engine", StringArray{ "Mersenne Twister", "PCG32", "Xoshiro256+", "Xoshiro128+", "SFC32", "SplitMix64", "Fast", "LCG", "Lehmer", "Lagged Fibonacci" }, 0));
+
+	layout.add(std::make_unique<juce::AudioParameterBool>("Voices", "Voices", false));
+	layout.add(std::make_unique<juce::AudioParameterFloat>("Attack", "Attack", NormalisableRange<float>(0.0f, 5.0f, 0.001f, 0.3f), 0.005f));
+	layout.add(std::make_unique<juce::AudioParameterFloat>("Decay", "Decay", NormalisableRange<float>(0.0f, 5.0f, 0.001f, 0.3f), 0.1f));
+	layout.add(std::make_unique<juce::AudioParameterFloat>("Sustain", "Sustain", NormalisableRange<float>(0.0f, 1.0f, 0.01f, 1.0f), 0.7f));
+	layout.add(std::make_unique<juce::AudioParameterFloat>("Release", "Release", NormalisableRange<float>(0.0f, 10.0f, 0.001f, 0.3f), 0.2f));
+	layout.add(std::make_unique<juce::AudioParameterChoice>("Filter", "Filter", StringArray{ "Off", "Low", "Band", "High" }, 0));
+	layout.add(std::make_unique<juce::AudioParameterFloat>("Resonance", "Resonance", NormalisableRange<float>(0.5f, 20.0f, 0.01f, 0.3f), 0.7f));
+
+	layout.add(std::make_unique<juce::AudioParameterChoice>("Dither", "Dither", StringArray{ "Off", "RPDF", "TPDF", "High Pass", "Shaped" }, 0));
+	layout.add(std::make_unique<juce::AudioParameterChoice>("DitherDepth", "DitherDepth", StringArray{ "16", "20", "24" }, 0));
 
 	return layout;
 }
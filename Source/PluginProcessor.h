@@ -10,12 +10,25 @@
 
 #include <JuceHeader.h>
 #include "NoiseGenerator.h"
+#include "ColouredNoise.h"
+#include "SpectralNoise.h"
+#include "SharedNoiseTable.h"
+#include "GainRamp.h"
+#include "NoiseBank.h"
+#include "ChannelWorkerPool.h"
+#include "DspLoadMeter.h"
+#include "RealtimeGuard.h"
+#include "AnalysisFeed.h"
+#include "NoiseVoices.h"
+#include "BandLimitedNoise.h"
+#include "NoiseDither.h"
 
 //==============================================================================
 class NoiseGeneratorAudioProcessor  : public juce::AudioProcessor
                             #if JucePlugin_Enable_ARA
                              , public juce::AudioProcessorARAExtension
                             #endif
+                             , private juce::Timer
 {
 public:
     //==============================================================================
@@ -24,6 +37,32 @@ public:
 
 	static const std::string paramsNames[];
 
+	// Every channel of every instance gets its own noise stream
+	static const uint32_t NOISE_SEED = 123;
+	static const uint32_t STREAMS_PER_INSTANCE = 1024;
+	static const uint32_t PREFILL_STREAM_OFFSET = 512;
+	static const uint32_t SPECTRAL_SEED = 0x5bd1e995;
+	static const uint32_t SHARED_SEED = 0x165667b1;
+	static const uint32_t VOICE_SEED = 0x9e3779b9;
+	static const int MAX_CHANNELS = 512;
+
+	// Shared table requests, Parallel and Prefill are picked up this often
+	static const int MESSAGE_POLL_MS = 100;
+
+	// Parallel channel rendering
+	static const int PARALLEL_MIN_CHANNELS = 16;
+	static const int CHANNELS_PER_WORKER = 8;
+
+	// Volume changes are smoothed over this long
+	static constexpr double GAIN_RAMP_SECONDS = 0.02;
+
+	// Bottom of the volume range is off
+	static constexpr float MIN_VOLUME_DECIBELS = -24.0f;
+
+	// Synced noise runs from here while the transport is stopped, far away from
+	// any playhead position
+	static const uint64_t FREE_RUN_POSITION = 1ull << 62;
+
     //==============================================================================
     void prepareToPlay (double sampleRate, int samplesPerBlock) override;
     void releaseResources() override;
@@ -33,6 +72,8 @@ public:
    #endif
 
     void processBlock (juce::AudioBuffer<float>&, juce::MidiBuffer&) override;
+    void processBlock (juce::AudioBuffer<double>&, juce::MidiBuffer&) override;
+    bool supportsDoublePrecisionProcessing() const override;
 
     //==============================================================================
     juce::AudioProcessorEditor* createEditor() override;
@@ -62,7 +103,100 @@ public:
 
 	APVTS apvts{ *this, nullptr, "Parameters", createParameterLayout() };
 
+	// Number of blocks where the prefill ring could not cover the whole block
+	uint32_t getPrefillUnderrunCount() const { return m_noiseBank.getUnderrunCount(); }
+
+	// Amplitude PDF of the PieceWise mode, bins spread evenly over [-1, 1). Builds
+	// the alias table on the calling thread, so message thread only. Empty weights
+	// restore the default shape.
+	void setAmplitudeWeights(const std::vector<float>& weights);
+	const std::vector<float>& getAmplitudeWeights() const { return m_amplitudeWeights; }
+
+	// Numbers separated by commas or whitespace, anything else is skipped
+	static std::vector<float> parseAmplitudeWeights(const juce::String& text);
+
+	AnalysisFeed& getAnalysisFeed() { return m_analysisFeed; }
+
+#if NOISE_GENERATOR_PROFILING
+	DspLoadMeter& getLoadMeter() { return m_loadMeter; }
+#endif
+
 private:	
+	// Acquires the shared tables the audio thread asked for, and starts or stops
+	// the workers and the prefill thread with Parallel and Prefill. Polled,
+	// because posting a message from the audio thread takes a lock and a syscall.
+	void timerCallback() override;
+
+	// Message thread, spectral frames delay the output by one frame.
+	// setLatencySamples calls back into the host, never from the audio thread.
+	void updateLatency();
+
+	// False if the data is not a binary state, nothing is changed then
+	bool setBinaryState(const void* data, int sizeInBytes);
+
+	struct RenderContext
+	{
+		NoiseGeneratorAudioProcessor* processor = nullptr;
+		float* const* channelData = nullptr;
+		double* const* doubleChannelData = nullptr;
+		int startSample = 0;
+		int numSamples = 0;
+
+		// Coloured or ramped noise is generated at unity level, then shaped and
+		// scaled over the whole block
+		ColouredNoise::Colour colour = ColouredNoise::Colour::White;
+		const ColouredNoise::Slope* slope = nullptr;
+		float generatorGain = 0.0f;
+		bool applyGain = false;
+		GainRamp::Segment gain;
+		int blockSize = 0;
+
+		// Synced noise is keyed by seed and channel and indexed by sample position
+		bool sync = false;
+		uint32_t seed = 0;
+		uint64_t position = 0;
+
+		// Spectral noise replaces the white noise generators
+		bool spectral = false;
+
+		// Band limited noise is generated at a lower rate and interpolated, colour included
+		bool bandLimited = false;
+
+		// Velvet impulses per sample
+		float velvetDensity = 0.0f;
+
+		// Word source of the white noise generators
+		NoiseEngine::Type engine = NoiseEngine::Type::MersenneTwister;
+
+		// User PDF for the PieceWise mode, nullptr for the default shape
+		const AliasTable* aliasTable = nullptr;
+
+		// Shared table replacing the white noise generators, nullptr if not used
+		const SharedNoiseTable* sharedTable = nullptr;
+
+		template <typename SampleType>
+		SampleType* getChannel(int channel) const
+		{
+			if constexpr (std::is_same<SampleType, double>::value)
+				return doubleChannelData[channel];
+			else
+				return channelData[channel];
+		}
+	};
+
+	// Float and double hosts share everything but the sample type
+	template <typename SampleType>
+	void processSamples(juce::AudioBuffer<SampleType>& buffer, juce::MidiBuffer& midiMessages);
+
+	// Voices are rendered between MIDI events, so notes start on their sample
+	template <typename SampleType>
+	void renderVoices(juce::AudioBuffer<SampleType>& buffer, const juce::MidiBuffer& midiMessages, int channels);
+
+	template <WhiteNoiseGenerator::DistributionType type, typename SampleType>
+	void renderNoise(juce::AudioBuffer<SampleType>& buffer, int channels, int startSample);
+	template <WhiteNoiseGenerator::DistributionType type, typename SampleType>
+	static void renderChannel(void* context, int channel);
+
 	//==============================================================================
 	std::atomic<float>* volumeParameter = nullptr;
 
@@ -70,8 +204,73 @@ private:
 	juce::AudioParameterBool* buttonBParameter = nullptr;
 	juce::AudioParameterBool* buttonCParameter = nullptr;
 	juce::AudioParameterBool* buttonDParameter = nullptr;
+	juce::AudioParameterBool* buttonEParameter = nullptr;
+	juce::AudioParameterBool* prefillParameter = nullptr;
+	juce::AudioParameterBool* parallelParameter = nullptr;
+	juce::AudioParameterChoice* colourParameter = nullptr;
+	std::atomic<float>* slopeParameter = nullptr;
+	juce::AudioParameterBool* syncParameter = nullptr;
+	juce::AudioParameterInt* seedParameter = nullptr;
+	juce::AudioParameterChoice* shapeParameter = nullptr;
+	std::atomic<float>* bandParameter = nullptr;
+	juce::AudioParameterChoice* frameParameter = nullptr;
+	std::atomic<float>* densityParameter = nullptr;
+	juce::AudioParameterBool* sharedParameter = nullptr;
+	juce::AudioParameterChoice* engineParameter = nullptr;
+	juce::AudioParameterBool* bandLimitParameter = nullptr;
+	std::atomic<float>* bandwidthParameter = nullptr;
+	juce::AudioParameterBool* voicesParameter = nullptr;
+	std::atomic<float>* attackParameter = nullptr;
+	std::atomic<float>* decayParameter = nullptr;
+	std::atomic<float>* sustainParameter = nullptr;
+	std::atomic<float>* releaseParameter = nullptr;
+	juce::AudioParameterChoice* filterParameter = nullptr;
+	std::atomic<float>* resonanceParameter = nullptr;
+	juce::AudioParameterChoice* ditherParameter = nullptr;
+	juce::AudioParameterChoice* ditherDepthParameter = nullptr;
+
+	std::vector<WhiteNoiseGenerator> m_whiteNoiseGenerators;
+	std::vector<ColouredNoise> m_colouredNoises;
+	ColouredNoise::Slope m_slope;
+	ColouredNoise::Slope m_bandLimitedSlope;
+	std::vector<SpectralNoise> m_spectralNoises;
+	SpectralShape m_spectralShape;
+	std::vector<BandLimitedNoise> m_bandLimitedNoises;
+	PolyphaseInterpolator m_polyphaseInterpolator;
+	std::vector<NoiseDither> m_noiseDithers;
+	uint32_t m_instanceIndex = 0;
+	uint32_t m_preparedInstanceIndex = 0;
+
+	NoiseBank m_noiseBank;
+
+	ChannelWorkerPool m_channelWorkerPool;
+	int m_parallelWorkers = 0;
+	RenderContext m_renderContext;
+
+	GainRamp m_gainRamp;
+
+	// Written by the audio thread, and by the message thread when a state is restored
+	std::atomic<uint64_t> m_freeRunPosition{ FREE_RUN_POSITION };
+
+	AliasTableSwap m_aliasTables;
+	std::vector<float> m_amplitudeWeights;
+
+	// Shared tables are held by the message thread and published to the audio
+	// thread once generated. They stay until the instance is destroyed.
+	std::shared_ptr<const SharedNoiseTable> m_sharedTableHolders[SharedNoiseTable::NUM_TYPES];
+	std::atomic<const SharedNoiseTable*> m_sharedTables[SharedNoiseTable::NUM_TYPES] = {};
+	std::atomic<uint32_t> m_sharedTableRequests{ 0 };
+	std::vector<SharedNoiseTable::Reader> m_sharedReaders;
+
+	// MIDI triggered noise, one stream per voice
+	NoiseVoices m_noiseVoices;
+
+	// First output channel for the editor
+	AnalysisFeed m_analysisFeed;
 
-	WhiteNoiseGenerator m_whiteNoiseGenerator[2] = {};
+#if NOISE_GENERATOR_PROFILING
+	DspLoadMeter m_loadMeter;
+#endif
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (NoiseGeneratorAudioProcessor)
 };
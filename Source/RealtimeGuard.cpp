@@ -0,0 +1,180 @@
+/*
+  ==============================================================================
+
+    RealtimeGuard.cpp
+    Created: 18 Oct 2026 8:21:05pm
+    Author:  zazz
+
+  ==============================================================================
+*/
+
+#include "RealtimeGuard.h"
+
+#if NOISE_GENERATOR_REALTIME_CHECKS
+
+#include <cstdlib>
+#include <new>
+
+#if NOISE_GENERATOR_REALTIME_INTERPOSE
+	#if ! JUCE_LINUX
+		#error NOISE_GENERATOR_REALTIME_INTERPOSE needs glibc
+	#endif
+
+	#include <cerrno>
+	#include <dlfcn.h>
+	#include <pthread.h>
+#endif
+
+static thread_local bool realtimeThread = false;
+static std::atomic<uint64_t> allocations{ 0 };
+static std::atomic<uint64_t> blockingCalls{ 0 };
+static std::atomic<size_t> lastAllocationSize{ 0 };
+
+//==============================================================================
+RealtimeGuard::Scope::Scope() : m_previous(realtimeThread)
+{
+	realtimeThread = true;
+}
+
+RealtimeGuard::Scope::~Scope()
+{
+	realtimeThread = m_previous;
+}
+
+void RealtimeGuard::checkBlocking()
+{
+	if (realtimeThread)
+		blockingCalls.fetch_add(1, std::memory_order_relaxed);
+}
+
+uint64_t RealtimeGuard::getAllocations()
+{
+	return allocations.load(std::memory_order_relaxed);
+}
+
+uint64_t RealtimeGuard::getBlockingCalls()
+{
+	return blockingCalls.load(std::memory_order_relaxed);
+}
+
+uint64_t RealtimeGuard::getViolations()
+{
+	return getAllocations() + getBlockingCalls();
+}
+
+size_t RealtimeGuard::getLastAllocationSize()
+{
+	return lastAllocationSize.load(std::memory_order_relaxed);
+}
+
+static void countAllocation(size_t size)
+{
+	if (realtimeThread)
+	{
+		allocations.fetch_add(1, std::memory_order_relaxed);
+		lastAllocationSize.store(size, std::memory_order_relaxed);
+	}
+}
+
+static void countFree(void* memory)
+{
+	if (memory != nullptr && realtimeThread)
+		allocations.fetch_add(1, std::memory_order_relaxed);
+}
+
+#if ! NOISE_GENERATOR_REALTIME_INTERPOSE
+//==============================================================================
+// The array, nothrow and sized forms all end up here by default
+void* operator new(std::size_t size)
+{
+	countAllocation(size);
+
+	if (void* memory = std::malloc(size > 0 ? size : 1))
+		return memory;
+
+	throw std::bad_alloc();
+}
+
+void operator delete(void* memory) noexcept
+{
+	countFree(memory);
+
+	std::free(memory);
+}
+
+#else
+//==============================================================================
+// glibc's own entry points, so nothing here calls back into itself. The
+// default operator new and delete end up here as well.
+extern "C"
+{
+	void* __libc_malloc(size_t size);
+	void* __libc_calloc(size_t count, size_t size);
+	void* __libc_realloc(void* memory, size_t size);
+	void* __libc_memalign(size_t alignment, size_t size);
+	void __libc_free(void* memory);
+}
+
+extern "C" void* malloc(size_t size) noexcept
+{
+	countAllocation(size);
+	return __libc_malloc(size);
+}
+
+extern "C" void* calloc(size_t count, size_t size) noexcept
+{
+	countAllocation(count * size);
+	return __libc_calloc(count, size);
+}
+
+extern "C" void* realloc(void* memory, size_t size) noexcept
+{
+	countAllocation(size);
+	return __libc_realloc(memory, size);
+}
+
+extern "C" int posix_memalign(void** memory, size_t alignment, size_t size) noexcept
+{
+	if (alignment < sizeof(void*) || (alignment & (alignment - 1)) != 0)
+		return EINVAL;
+
+	countAllocation(size);
+	*memory = __libc_memalign(alignment, size);
+	return *memory != nullptr ? 0 : ENOMEM;
+}
+
+extern "C" void* aligned_alloc(size_t alignment, size_t size) noexcept
+{
+	countAllocation(size);
+	return __libc_memalign(alignment, size);
+}
+
+extern "C" void free(void* memory) noexcept
+{
+	countFree(memory);
+
+	__libc_free(memory);
+}
+
+// std::mutex, juce::CriticalSection and juce::WaitableEvent all lock here.
+// The real function is looked up on first use, dlsym takes no such lock.
+extern "C" int pthread_mutex_lock(pthread_mutex_t* mutex) noexcept
+{
+	using MutexLock = int (*)(pthread_mutex_t*);
+	static std::atomic<MutexLock> next{ nullptr };
+
+	if (realtimeThread)
+		blockingCalls.fetch_add(1, std::memory_order_relaxed);
+
+	MutexLock lock = next.load(std::memory_order_acquire);
+	if (lock == nullptr)
+	{
+		lock = (MutexLock)dlsym(RTLD_NEXT, "pthread_mutex_lock");
+		next.store(lock, std::memory_order_release);
+	}
+
+	return lock(mutex);
+}
+#endif
+
+#endif
@@ -0,0 +1,75 @@
+/*
+  ==============================================================================
+
+    RealtimeGuard.h
+    Created: 18 Oct 2026 8:21:05pm
+    Author:  zazz
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+// Debug builds count heap use on the audio thread and the channel workers, set
+// to 0 or 1 to override
+#ifndef NOISE_GENERATOR_REALTIME_CHECKS
+	#define NOISE_GENERATOR_REALTIME_CHECKS JUCE_DEBUG
+#endif
+
+// Linux test builds also replace malloc and pthread_mutex_lock for the whole
+// process, never set this in a plugin
+#ifndef NOISE_GENERATOR_REALTIME_INTERPOSE
+	#define NOISE_GENERATOR_REALTIME_INTERPOSE 0
+#endif
+
+//==============================================================================
+// Global operator new and delete are replaced for this module and count every
+// call made while the calling thread is inside a Scope. Locks taken through
+// ScopedLock and calls marked with checkBlocking() are counted too. With
+// NOISE_GENERATOR_REALTIME_INTERPOSE malloc, calloc, realloc, free and
+// pthread_mutex_lock are counted instead, which also sees JUCE, the standard
+// library and std::mutex. Other syscalls are never seen.
+namespace RealtimeGuard
+{
+#if NOISE_GENERATOR_REALTIME_CHECKS
+	// Marks the calling thread as real time for its lifetime, scopes can nest
+	class Scope
+	{
+	public:
+		Scope();
+		~Scope();
+
+	private:
+		bool m_previous;
+
+		JUCE_DECLARE_NON_COPYABLE (Scope)
+	};
+
+	// Call right before anything that can block or enter the kernel
+	void checkBlocking();
+
+	// Any thread
+	uint64_t getAllocations();
+	uint64_t getBlockingCalls();
+	uint64_t getViolations();
+	size_t getLastAllocationSize();
+#else
+	inline void checkBlocking() {}
+#endif
+
+	// juce::ScopedLock that is counted when taken inside a Scope
+	class ScopedLock
+	{
+	public:
+		explicit ScopedLock(const juce::CriticalSection& lock) : m_lock((checkBlocking(), lock))
+		{
+		}
+
+	private:
+		const juce::ScopedLock m_lock;
+
+		JUCE_DECLARE_NON_COPYABLE (ScopedLock)
+	};
+}
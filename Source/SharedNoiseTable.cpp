@@ -0,0 +1,104 @@
+/*
+  ==============================================================================
+
+    SharedNoiseTable.cpp
+    Created: 18 Oct 2026 4:51:08pm
+    Author:  zazz
+
+  ==============================================================================
+*/
+
+#include "SharedNoiseTable.h"
+
+//==============================================================================
+std::shared_ptr<const SharedNoiseTable> SharedNoiseTable::acquire(WhiteNoiseGenerator::DistributionType distributionType)
+{
+	// Weak, so the last instance to let go frees the table
+	static std::mutex mutex;
+	static std::weak_ptr<const SharedNoiseTable> tables[NUM_TYPES];
+
+	const int index = (int)distributionType;
+	if (index < 0 || index >= NUM_TYPES)
+		return nullptr;
+
+	std::lock_guard<std::mutex> lock(mutex);
+
+	auto table = tables[index].lock();
+	if (table == nullptr)
+	{
+		table = std::make_shared<const SharedNoiseTable>(distributionType);
+		tables[index] = table;
+	}
+
+	return table;
+}
+
+SharedNoiseTable::SharedNoiseTable(WhiteNoiseGenerator::DistributionType distributionType)
+{
+	m_data.resize((size_t)(SIZE + SEGMENT));
+
+	// Unity gain, the trim is applied by whoever reads it
+	WhiteNoiseGenerator generator;
+	generator.setStream(TABLE_SEED, (uint32_t)distributionType);
+	generator.setDistributionType(distributionType);
+	generator.processBlock(m_data.data(), SIZE, 1.0f);
+
+	std::copy(m_data.begin(), m_data.begin() + SEGMENT, m_data.begin() + SIZE);
+}
+
+//==============================================================================
+void SharedNoiseTable::Reader::setStream(uint32_t seed, uint32_t stream)
+{
+	const uint32_t key[2] = { seed, stream };
+	const uint32_t counter[4] = { 0, 0, 0, 0 };
+	uint32_t bits[4];
+	NoiseKernels::philoxBlock(key, counter, bits);
+
+	// The phase keeps instances off common segment boundaries
+	m_segment = bits[0] & (uint32_t)(NUM_SEGMENTS - 1);
+	m_stride = (bits[1] | 1u) & (uint32_t)(NUM_SEGMENTS - 1);
+	m_phase = bits[2] & (uint32_t)(SEGMENT - 1);
+	m_offset = 0;
+	m_visited = 0;
+	m_sign = (bits[3] & 1u) ? 1.0f : -1.0f;
+}
+
+template <typename SampleType>
+void SharedNoiseTable::Reader::read(const SharedNoiseTable& table, SampleType* out, int numSamples, float gain)
+{
+	const float* data = table.getData();
+
+	while (numSamples > 0)
+	{
+		const int count = std::min(numSamples, SEGMENT - (int)m_offset);
+		const float* segment = data + ((size_t)m_segment << SEGMENT_BITS) + m_phase + m_offset;
+		const float scale = m_sign * gain;
+
+		for (int i = 0; i < count; i++)
+		{
+			out[i] = (SampleType)(scale * segment[i]);
+		}
+
+		out += count;
+		numSamples -= count;
+		m_offset += (uint32_t)count;
+
+		if (m_offset == (uint32_t)SEGMENT)
+		{
+			m_offset = 0;
+			m_segment = (m_segment + m_stride) & (uint32_t)(NUM_SEGMENTS - 1);
+
+			// A new order, phase and sign for every pass
+			if (++m_visited == (uint32_t)NUM_SEGMENTS)
+			{
+				m_visited = 0;
+				m_stride = (m_stride + 2u) & (uint32_t)(NUM_SEGMENTS - 1);
+				m_phase = (m_phase + PASS_PHASE_STEP) & (uint32_t)(SEGMENT - 1);
+				m_sign = -m_sign;
+			}
+		}
+	}
+}
+
+template void SharedNoiseTable::Reader::read<float>(const SharedNoiseTable& table, float* out, int numSamples, float gain);
+template void SharedNoiseTable::Reader::read<double>(const SharedNoiseTable& table, double* out, int numSamples, float gain);
@@ -0,0 +1,80 @@
+/*
+  ==============================================================================
+
+    SharedNoiseTable.h
+    Created: 18 Oct 2026 4:51:08pm
+    Author:  zazz
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <memory>
+#include <mutex>
+#include "NoiseGenerator.h"
+
+//==============================================================================
+// Precomputed noise shared by every instance in the process, one table per
+// distribution. Instances read it in segments, each from its own start and
+// stride, so playing costs a scaled copy and the memory does not grow with the
+// number of instances.
+class SharedNoiseTable
+{
+public:
+	// Distributions below Velvet, velvet noise depends on its density
+	static const int NUM_TYPES = (int)WhiteNoiseGenerator::DistributionType::Velvet;
+
+	// 2^20 samples, almost 22 seconds at 48 kHz
+	static const int SIZE_BITS = 20;
+	static const int SIZE = 1 << SIZE_BITS;
+
+	// Reads are contiguous within a segment
+	static const int SEGMENT_BITS = 10;
+	static const int SEGMENT = 1 << SEGMENT_BITS;
+	static const int NUM_SEGMENTS = SIZE / SEGMENT;
+
+	static const uint32_t TABLE_SEED = 0x27d4eb2f;
+
+	// Returns the process wide table, generating it if no instance holds it.
+	// Takes a lock and may allocate, not for the audio thread.
+	static std::shared_ptr<const SharedNoiseTable> acquire(WhiteNoiseGenerator::DistributionType distributionType);
+
+	explicit SharedNoiseTable(WhiteNoiseGenerator::DistributionType distributionType);
+
+	// Table with the first segment repeated at the end, so no read has to wrap
+	const float* getData() const
+	{
+		return m_data.data();
+	}
+
+	//==============================================================================
+	// Position of one channel in the table. Segments are visited with an odd
+	// stride, which covers every segment once per pass. Each pass changes the
+	// stride and phase and flips the sign, all shared distributions are symmetric.
+	class Reader
+	{
+	public:
+		Reader() {};
+
+		void setStream(uint32_t seed, uint32_t stream);
+
+		// Float or double
+		template <typename SampleType>
+		void read(const SharedNoiseTable& table, SampleType* out, int numSamples, float gain);
+
+	private:
+		// About 0.618 of a segment
+		static const uint32_t PASS_PHASE_STEP = 633;
+
+		uint32_t m_segment = 0;
+		uint32_t m_stride = 1;
+		uint32_t m_phase = 0;
+		uint32_t m_offset = 0;
+		uint32_t m_visited = 0;
+		float m_sign = 1.0f;
+	};
+
+private:
+	std::vector<float> m_data;
+};
@@ -0,0 +1,273 @@
+/*
+  ==============================================================================
+
+    SpectralNoise.cpp
+    Created: 18 Oct 2026 3:04:51pm
+    Author:  zazz
+
+  ==============================================================================
+*/
+
+#include "SpectralNoise.h"
+
+static const double PI = 3.14159265358979323846;
+
+// Level outside octave bands and inside notches
+static const float STOP_DECIBELS = -60.0f;
+
+//==============================================================================
+void SpectralShape::prepare(double sampleRate)
+{
+	m_sampleRate = sampleRate;
+
+	// Squared sine windows half a frame apart sum to one, so the overlap-add
+	// keeps a constant variance
+	m_ffts.clear();
+	m_windows.clear();
+	for (int order = MIN_ORDER; order <= MAX_ORDER; order++)
+	{
+		m_ffts.emplace_back(order);
+
+		const int size = 1 << order;
+		std::vector<float> window((size_t)size);
+		for (int i = 0; i < size; i++)
+		{
+			window[(size_t)i] = (float)sin(PI * (i + 0.5) / size);
+		}
+		m_windows.push_back(std::move(window));
+	}
+
+	m_phases.resize((size_t)1 << PHASE_BITS);
+	for (size_t i = 0; i < m_phases.size(); i++)
+	{
+		m_phases[i] = std::polar(1.0f, (float)(2.0 * PI * (double)i / (double)m_phases.size()));
+	}
+
+	submitMagnitudes();
+	update();
+}
+
+void SpectralShape::request(Shape shape, float frequency, int order)
+{
+	order = order < MIN_ORDER ? MIN_ORDER : order > MAX_ORDER ? MAX_ORDER : order;
+	if (shape == m_shape && frequency == m_frequency && order == m_order)
+		return;
+
+	// Approximates the long term average speech spectrum
+	static const float speechFrequencies[] = { 63.0f, 125.0f, 250.0f, 500.0f, 1000.0f, 2000.0f, 4000.0f, 8000.0f, 16000.0f };
+	static const float speechDecibels[] = { -14.0f, -4.0f, 0.0f, 0.0f, -6.0f, -12.0f, -18.0f, -25.0f, -32.0f };
+
+	switch (shape)
+	{
+	case Shape::Speech:
+	{
+		requestCurve(speechFrequencies, speechDecibels, 9, order);
+		break;
+	}
+	case Shape::Octave:
+	{
+		const float frequencies[] = { frequency * 0.66f, frequency * 0.7071f, frequency * 1.4142f, frequency * 1.5157f };
+		const float decibels[] = { STOP_DECIBELS, 0.0f, 0.0f, STOP_DECIBELS };
+		requestCurve(frequencies, decibels, 4, order);
+		break;
+	}
+	case Shape::Notch:
+	{
+		// A third of an octave wide
+		const float frequencies[] = { frequency * 0.8909f, frequency * 0.9715f, frequency * 1.0293f, frequency * 1.1225f };
+		const float decibels[] = { 0.0f, STOP_DECIBELS, STOP_DECIBELS, 0.0f };
+		requestCurve(frequencies, decibels, 4, order);
+		break;
+	}
+	default:
+	{
+		const float flat = 0.0f;
+		requestCurve(&frequency, &flat, 1, order);
+		break;
+	}
+	}
+
+	m_shape = shape;
+	m_frequency = frequency;
+}
+
+void SpectralShape::requestCurve(const float* frequencies, const float* decibels, int numPoints, int order)
+{
+	// Any preset asked for next is built again
+	m_frequency = -1.0f;
+	m_order = order < MIN_ORDER ? MIN_ORDER : order > MAX_ORDER ? MAX_ORDER : order;
+	m_numPoints = numPoints < MAX_POINTS ? numPoints : MAX_POINTS;
+
+	for (int i = 0; i < m_numPoints; i++)
+	{
+		m_logFrequencies[i] = log2f(frequencies[i] > 1.0f ? frequencies[i] : 1.0f);
+		m_decibels[i] = decibels[i];
+	}
+
+	submitMagnitudes();
+}
+
+//==============================================================================
+void SpectralShape::submitMagnitudes()
+{
+	if (m_numPoints <= 0)
+		return;
+
+	const int size = 1 << m_order;
+	const int half = size / 2;
+
+	auto magnitudes = std::make_unique<Magnitudes>();
+	magnitudes->order = m_order;
+	magnitudes->values.resize((size_t)half + 1);
+
+	// No DC
+	float* values = magnitudes->values.data();
+	values[0] = 0.0f;
+
+	double power = 0.0;
+	int point = 0;
+
+	for (int bin = 1; bin <= half; bin++)
+	{
+		const float logFrequency = log2f((float)(bin * m_sampleRate / size));
+
+		while (point < m_numPoints - 1 && m_logFrequencies[point + 1] <= logFrequency)
+		{
+			point++;
+		}
+
+		float decibels = m_decibels[point];
+		if (point < m_numPoints - 1 && logFrequency > m_logFrequencies[point])
+		{
+			const float fraction = (logFrequency - m_logFrequencies[point]) / (m_logFrequencies[point + 1] - m_logFrequencies[point]);
+			decibels += fraction * (m_decibels[point + 1] - m_decibels[point]);
+		}
+
+		const float magnitude = powf(10.0f, 0.05f * decibels);
+		values[bin] = magnitude;
+
+		// Bins below Nyquist appear twice in the full spectrum
+		power += (bin == half ? 1.0 : 2.0) * magnitude * magnitude;
+	}
+
+	// Inverse FFT divides by size, so a frame has variance sum |X|^2 / size^2
+	const float scale = power > 0.0 ? (float)(OUTPUT_RMS * size / sqrt(power)) : 0.0f;
+
+	for (int bin = 1; bin <= half; bin++)
+	{
+		values[bin] *= scale;
+	}
+
+	m_magnitudes.submit(std::move(magnitudes));
+}
+
+//==============================================================================
+void SpectralNoise::prepare(uint32_t seed, uint32_t stream)
+{
+	const size_t maxSize = (size_t)1 << SpectralShape::MAX_ORDER;
+
+	m_spectrum.resize(maxSize);
+	m_bits.resize(maxSize / 2);
+	m_ready.resize(maxSize);
+	m_tail.resize(maxSize / 2);
+
+	m_random.setKey(seed, stream);
+	m_position = 0;
+
+	reset();
+}
+
+void SpectralNoise::reset()
+{
+	std::fill(m_tail.begin(), m_tail.end(), 0.0f);
+	m_readPosition = (int)m_ready.size();
+}
+
+template <typename SampleType>
+void SpectralNoise::process(SampleType* out, int numSamples, float gain, const SpectralShape& shape)
+{
+	if (shape.getOrder() != m_order)
+	{
+		m_order = shape.getOrder();
+		reset();
+	}
+
+	const int size = shape.getSize();
+
+	while (numSamples > 0)
+	{
+		if (m_readPosition >= size)
+		{
+			synthesise(shape);
+			m_readPosition = 0;
+		}
+
+		const int count = numSamples < size - m_readPosition ? numSamples : size - m_readPosition;
+		const float* ready = m_ready.data() + m_readPosition;
+
+		for (int i = 0; i < count; i++)
+		{
+			out[i] = (SampleType)(gain * ready[i]);
+		}
+
+		out += count;
+		numSamples -= count;
+		m_readPosition += count;
+	}
+}
+
+template void SpectralNoise::process<float>(float* out, int numSamples, float gain, const SpectralShape& shape);
+template void SpectralNoise::process<double>(double* out, int numSamples, float gain, const SpectralShape& shape);
+
+//==============================================================================
+void SpectralNoise::synthesise(const SpectralShape& shape)
+{
+	const int size = shape.getSize();
+	const int half = size / 2;
+	const float* magnitudes = shape.getMagnitudes();
+	const float* window = shape.getWindow();
+	const std::complex<float>* phases = shape.getPhases();
+	const int phaseMask = (1 << SpectralShape::PHASE_BITS) - 1;
+
+	// One word per bin, two phases in each
+	m_random.processBits(m_position, m_bits.data(), half);
+	m_position += (uint64_t)half;
+
+	// Spectra a and b are Hermitian, so the inverse of a + ib is the real frame a
+	// plus i times the real frame b
+	std::complex<float>* spectrum = m_spectrum.data();
+	spectrum[0] = 0.0f;
+
+	for (int bin = 1; bin < half; bin++)
+	{
+		const uint32_t bits = m_bits[(size_t)bin];
+		const std::complex<float> a = magnitudes[bin] * phases[bits >> (32 - SpectralShape::PHASE_BITS)];
+		const std::complex<float> b = magnitudes[bin] * phases[(bits >> 4) & (uint32_t)phaseMask];
+
+		spectrum[bin] = std::complex<float>(a.real() - b.imag(), a.imag() + b.real());
+		spectrum[size - bin] = std::complex<float>(a.real() + b.imag(), b.real() - a.imag());
+	}
+
+	// Nyquist is real in both, only its sign is random
+	const float nyquist = magnitudes[half];
+	spectrum[half] = std::complex<float>((m_bits[0] & 1u) ? nyquist : -nyquist, (m_bits[0] & 2u) ? nyquist : -nyquist);
+
+	shape.getFft().perform(spectrum, true);
+
+	// Frame a starts at 0, frame b half a frame later
+	float* ready = m_ready.data();
+	float* tail = m_tail.data();
+
+	for (int i = 0; i < half; i++)
+	{
+		ready[i] = tail[i] + window[i] * spectrum[i].real();
+	}
+	for (int i = 0; i < half; i++)
+	{
+		ready[half + i] = window[half + i] * spectrum[half + i].real() + window[i] * spectrum[i].imag();
+	}
+	for (int i = 0; i < half; i++)
+	{
+		tail[i] = window[half + i] * spectrum[half + i].imag();
+	}
+}
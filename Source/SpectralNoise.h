@@ -0,0 +1,149 @@
+/*
+  ==============================================================================
+
+    SpectralNoise.h
+    Created: 18 Oct 2026 3:04:51pm
+    Author:  zazz
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "NoiseGenerator.h"
+#include "NoiseAnalysis.h"
+
+//==============================================================================
+// Target magnitude per FFT bin, shared by all channels. Magnitudes are built on
+// the message thread and taken by the audio thread between blocks.
+class SpectralShape
+{
+public:
+	SpectralShape() {};
+
+	enum Shape
+	{
+		Off,
+		Speech,
+		Octave,
+		Notch
+	};
+
+	// Frames are 2^order samples long
+	static const int MIN_ORDER = 9;
+	static const int MAX_ORDER = 13;
+	static const int MAX_POINTS = 16;
+
+	// Phases come from a table of 2^PHASE_BITS unit vectors
+	static const int PHASE_BITS = 12;
+
+	// Same RMS as the normal distribution at unity gain
+	static constexpr float OUTPUT_RMS = 0.65f;
+
+	// Allocates for every order and builds the last requested shape at the new
+	// rate, not real time safe
+	void prepare(double sampleRate);
+
+	// Message thread. Presets, frequency is the centre of the Octave band and of
+	// the Notch. Only builds when anything changed.
+	void request(Shape shape, float frequency, int order);
+	// Message thread. Any curve, decibels over ascending frequencies in Hz,
+	// interpolated on a log frequency axis and held flat past both ends.
+	void requestCurve(const float* frequencies, const float* decibels, int numPoints, int order);
+
+	// Audio thread, takes the newest magnitudes at the start of a block
+	void update()
+	{
+		m_current = m_magnitudes.acquire();
+	}
+
+	int getOrder() const
+	{
+		return m_current != nullptr ? m_current->order : MIN_ORDER;
+	}
+	int getSize() const
+	{
+		return 1 << getOrder();
+	}
+	// Shape changes reach the output up to one frame later
+	static int getLatencySamples(int order)
+	{
+		return 1 << (order < MIN_ORDER ? MIN_ORDER : order > MAX_ORDER ? MAX_ORDER : order);
+	}
+
+	const NoiseAnalysis::Fft& getFft() const
+	{
+		return m_ffts[(size_t)(getOrder() - MIN_ORDER)];
+	}
+	const float* getWindow() const
+	{
+		return m_windows[(size_t)(getOrder() - MIN_ORDER)].data();
+	}
+	const float* getMagnitudes() const
+	{
+		return m_current->values.data();
+	}
+	const std::complex<float>* getPhases() const
+	{
+		return m_phases.data();
+	}
+
+private:
+	struct Magnitudes
+	{
+		int order = 0;
+		std::vector<float> values;
+	};
+
+	void submitMagnitudes();
+
+	// Message thread
+	double m_sampleRate = 48000.0;
+	int m_order = 11;
+	Shape m_shape = Shape::Off;
+	float m_frequency = 0.0f;
+
+	float m_logFrequencies[MAX_POINTS] = {};
+	float m_decibels[MAX_POINTS] = {};
+	int m_numPoints = 1;
+
+	// Read by both, only written in prepare
+	std::vector<NoiseAnalysis::Fft> m_ffts;
+	std::vector<std::vector<float>> m_windows;
+	std::vector<std::complex<float>> m_phases;
+
+	TableSwap<Magnitudes> m_magnitudes;
+	const Magnitudes* m_current = nullptr;
+};
+
+//==============================================================================
+// Random phase frames with the shape's magnitudes, overlap-added with a sine
+// window at half frame hops. One complex inverse FFT yields two real frames,
+// so the cost per sample is O(log N) whatever the shape.
+class SpectralNoise
+{
+public:
+	SpectralNoise() {};
+
+	// Allocates for the largest order, not real time safe
+	void prepare(uint32_t seed, uint32_t stream);
+	void reset();
+
+	// Float or double, frames are synthesised in float
+	template <typename SampleType>
+	void process(SampleType* out, int numSamples, float gain, const SpectralShape& shape);
+
+private:
+	void synthesise(const SpectralShape& shape);
+
+	Philox m_random;
+	uint64_t m_position = 0;
+	int m_order = 0;
+
+	// Samples of the last frame pair and the second frame's overlap into the next
+	std::vector<std::complex<float>> m_spectrum;
+	std::vector<uint32_t> m_bits;
+	std::vector<float> m_ready;
+	std::vector<float> m_tail;
+	int m_readPosition = 0;
+};